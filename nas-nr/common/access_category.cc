@@ -0,0 +1,81 @@
+#include "access_category.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+bool any_of_ids(const uint16_t* ids, int n, uint16_t id) {
+    if (id == 0) return false;
+    for (int i = 0; i < n; ++i) {
+        if (ids[i] == id) return true;
+    }
+    return false;
+}
+
+bool same_os_app(const octet_t& v, const access_attempt_t& a) {
+    if (!a.os_id || int(v.size()) != 17 + a.os_app_id_length) return false;
+    if (std::memcmp(v.data(), a.os_id, 16) != 0) return false;
+    return a.os_app_id_length == 0 ||
+           std::memcmp(v.data() + 17, a.os_app_id, size_t(a.os_app_id_length)) == 0;
+}
+} // namespace
+
+access_category_matcher::access_category_matcher(
+    const operator_defined_access_category_definitions_t& definitions) {
+    namespace c = access_category_criteria;
+
+    for (const auto& d : definitions.definitions) {
+        const auto& k = d.components;
+        rule_t      r;
+        r.precedence = d.precedence;
+        r.category   = uint8_t(32 + d.number); // coded as the number less 32
+        r.psac       = d.psac;
+        r.types      = k.types;
+        if (d.standardized_access_category.present)
+            r.standardized = d.standardized_access_category.v;
+
+        r.dnns   = uint16_t(ids.size());
+        r.dnns_n = uint16_t(k.dnn_ids.size());
+        ids.insert(ids.end(), k.dnn_ids.begin(), k.dnn_ids.end());
+        r.s_nssais   = uint16_t(ids.size());
+        r.s_nssais_n = uint16_t(k.s_nssai_ids.size());
+        ids.insert(ids.end(), k.s_nssai_ids.begin(), k.s_nssai_ids.end());
+        r.os_apps   = uint16_t(os_apps.size());
+        r.os_apps_n = uint16_t(k.os_apps.size());
+        os_apps.insert(os_apps.end(), k.os_apps.begin(), k.os_apps.end());
+
+        // a definition without criteria matches nothing
+        if (r.types & (1u << c::dnn | 1u << c::os_id_os_app_id | 1u << c::s_nssai))
+            rules.push_back(r);
+    }
+    std::stable_sort(rules.begin(), rules.end(), [](const rule_t& a, const rule_t& b) {
+        return a.precedence < b.precedence;
+    });
+}
+
+bool access_category_matcher::match(const access_attempt_t&   attempt,
+                                    access_category_match_t* ret) const {
+    namespace c = access_category_criteria;
+
+    for (const auto& r : rules) {
+        if ((r.types & 1u << c::dnn) &&
+            !any_of_ids(ids.data() + r.dnns, r.dnns_n, attempt.dnn_id))
+            continue;
+        if ((r.types & 1u << c::s_nssai) &&
+            !any_of_ids(ids.data() + r.s_nssais, r.s_nssais_n, attempt.s_nssai_id))
+            continue;
+        if (r.types & 1u << c::os_id_os_app_id) {
+            bool found = false;
+            for (auto i = 0; i < r.os_apps_n && !found; ++i)
+                found = same_os_app(os_apps[r.os_apps + i], attempt);
+            if (!found) continue;
+        }
+
+        ret->precedence   = r.precedence;
+        ret->category     = r.category;
+        ret->standardized = r.standardized;
+        ret->psac         = r.psac != 0;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "ies.hh"
+
+// what a UE access attempt is for, ids as intern.hh hands them out, 0 for none
+struct access_attempt_t {
+    uint16_t       dnn_id           = 0;
+    uint16_t       s_nssai_id       = 0;
+    const uint8_t* os_id            = nullptr; // 16 octets, nullptr for none
+    const uint8_t* os_app_id        = nullptr;
+    int            os_app_id_length = 0;
+};
+
+// the definition an access attempt falls in
+struct access_category_match_t {
+    uint8_t precedence   = 0;
+    uint8_t category     = 0; // operator-defined access category number, 32 to 63
+    uint8_t standardized = 0; // standardized access category, 0xff when not given
+    bool    psac         = false;
+};
+
+/* Operator-defined access category definitions compiled for matching, TS 24.501 4.5.3.
+ * An attempt matches a definition when it matches every criteria type the definition
+ * has, and a type when it matches any of its values; the definition of lowest
+ * precedence value wins. Rules are sorted once, their DNN and S-NSSAI values are the
+ * interned ids held in one flat array, so an attempt is a scan of small integers. */
+struct access_category_matcher {
+    access_category_matcher() = default;
+    explicit access_category_matcher(
+        const operator_defined_access_category_definitions_t& definitions);
+
+    // false when no definition matches, then a standardized category applies
+    bool match(const access_attempt_t& attempt, access_category_match_t* ret) const;
+
+    struct rule_t {
+        uint8_t  precedence   = 0;
+        uint8_t  category     = 0;
+        uint8_t  standardized = 0xff;
+        uint8_t  psac         = 0;
+        uint8_t  types        = 0; // access_category_criteria_t::types
+        uint16_t dnns         = 0; // first of the DNN ids in ids
+        uint16_t dnns_n       = 0;
+        uint16_t s_nssais     = 0; // first of the S-NSSAI ids in ids
+        uint16_t s_nssais_n   = 0;
+        uint16_t os_apps      = 0; // first in os_apps
+        uint16_t os_apps_n    = 0;
+    };
+
+    std::vector< rule_t >   rules   = {}; // by precedence
+    std::vector< uint16_t > ids     = {};
+    std::vector< octet_t >  os_apps = {}; // OS Id (16), then the OS App Id
+};
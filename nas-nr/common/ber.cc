@@ -16,6 +16,7 @@ result_t de_t_octet(dissector d, context* ctx, uint8_t ieid, opt_t< octet_t >* r
 
     auto ie = d.uint8(true);
     if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {len};
     ret->present = true;
 
     de_octet(d, ctx, &ret->v).step(d);
@@ -23,13 +24,12 @@ result_t de_t_octet(dissector d, context* ctx, uint8_t ieid, opt_t< octet_t >* r
     return {len};
 }
 
-result_t de_tl_octet(dissector d, context*, uint8_t ieid, opt_t< octet_t >* ret) {
-    auto len    = d.length;
-
+result_t de_tl_octet(dissector d, context* ctx, uint8_t ieid, opt_t< octet_t >* ret) {
     auto ie     = d.uint8(true);
     if (ie != ieid && ieid != 0xffu) return {0};
 
     auto length = d.uint8(true);
+    if (!ie_selected(ctx, ie)) return {1 + 1 + length};
     ret->present = true;
 
     ret->v = octet_t(d.safe_ptr(), d.safe_ptr() + d.safe_length(length));
@@ -37,11 +37,12 @@ result_t de_tl_octet(dissector d, context*, uint8_t ieid, opt_t< octet_t >* ret)
     return {1 + 1 + length};
 }
 
-result_t de_tle_octet(dissector d, context*, uint8_t ieid, opt_t< octet_t >* ret) {
+result_t de_tle_octet(dissector d, context* ctx, uint8_t ieid, opt_t< octet_t >* ret) {
     auto ie     = d.uint8(true);
     if (ie != ieid && ieid != 0xffu) return {0};
 
     auto length = d.uint16(true);
+    if (!ie_selected(ctx, ie)) return {1 + 2 + length};
     ret->present = true;
 
     ret->v = octet_t(d.safe_ptr(), d.safe_ptr() + d.safe_length(length));
@@ -51,13 +52,17 @@ result_t de_tle_octet(dissector d, context*, uint8_t ieid, opt_t< octet_t >* ret
 
 result_t de_le_octet(dissector d, context*ctx, octet_t*ret) {
     auto l = d.uint16(true);
+    if (!mandatory_ie_selected(ctx)) return {2 + int(l)};
     de_octet(d.slice(l), ctx, ret).step(d);
     return {2+int(l)};
 }
 
 result_t de_l_octet(dissector d, context*ctx, octet_t*ret) {
     auto l = d.uint8(true);
-    de_octet(d.slice(l), ctx, ret).step(d);
+    if (!mandatory_ie_selected(ctx)) return {1 + int(l)};
+    // the slice is not bounded, a length past the contents would read beyond them
+    const auto left = d.length > 0 ? d.length : 0;
+    de_octet(d.slice(l > left ? left : l), ctx, ret).step(d);
     return {1+int(l)};
 }
 
@@ -65,6 +70,7 @@ result_t de_l_octet(dissector d, context*ctx, octet_t*ret) {
 result_t de_tv_short(dissector d, context* ctx, uint8_t ieid, opt_t< uint8_t >* ret) {
     auto iei = d.uint8(false) & 0xf0u;
     if (iei != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, iei)) return {1};
 
     ret->present = true;
     ret->v = d.uint8() & 0x0fu;
@@ -78,7 +84,9 @@ result_t de_nibble(dissector d, context* ctx, uint8_t* ret) {
 }
 
 result_t de_t_uint16(dissector d, context* ctx, uint8_t ieid, opt_t< uint16_t >* ret) {
-    if (d.uint8(true) != ieid && ieid != 0xffu) return {0};
+    const auto ie = d.uint8(true);
+    if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + 2};
 
     ret->present = true;
     ret->v       = d.uint16();
@@ -87,7 +95,9 @@ result_t de_t_uint16(dissector d, context* ctx, uint8_t ieid, opt_t< uint16_t >*
 }
 
 result_t de_tl_uint16(dissector d, context* ctx, uint8_t ieid, opt_t< uint16_t >* ret) {
-    if (d.uint8(true) != ieid && ieid != 0xffu) return {0};
+    const auto ie = d.uint8(true);
+    if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + 1 + 2};
 
     ret->present = true;
     ret->v       = d.uint16(1);
@@ -100,7 +110,9 @@ result_t de_t_uint8(dissector         d,
                   uint8_t           ieid,
                   opt_t< uint8_t >* ret,
                   uint8_t           mask ) {
-    if (d.uint8(true) != ieid && ieid != 0xffu) return {0};
+    const auto ie = d.uint8(true);
+    if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + 1};
 
     ret->present = true;
     ret->v       = mask_u8(d.uint8(true), mask);
@@ -111,13 +123,16 @@ result_t de_t_uint8(dissector         d,
 result_t de_t(dissector d, context* ctx, uint8_t ieid, uint8_t* ret) {
     auto iei = d.uint8();
     if (iei != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, iei)) return {1};
     *ret = 1;
 
     return {1};
 }
 
 result_t de_tl_uint8(dissector d, context* ctx, uint8_t ieid, opt_t<uint8_t>*ret){
-    if (d.uint8(true) != ieid && ieid != 0xffu) return {0};
+    const auto ie = d.uint8(true);
+    if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {3};
 
     d.step(1); // length
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "core.hh"
+#include "decode_mask.hh"
 #include "definitions.hh"
 #include "dissector.hh"
 #include "nas.hh"
@@ -37,16 +38,74 @@ result_t de_l_octet(dissector d, context* ctx, octet_t* ret);
 
 result_t de_nibble(dissector d, context* ctx, uint8_t* ret);
 
+/* Value part of an IE kept raw and decoded by func on the first get(), which caches the
+ * result. Jobs reading a few IEs of a message do not pay for decoding the rest.
+ * get() is not synchronized, decode_lazy_ies() a message before sharing it. */
+template < typename element_t, dissect_func_t< element_t > func >
+struct lazy_t {
+    octet_t                              raw     = {};
+    mutable std::shared_ptr< element_t > decoded = {};
+
+    const element_t* get(context* ctx = nullptr) const {
+        if (decoded) return decoded.get();
+        decoded = std::make_shared< element_t >();
+
+        dissector d = {};
+        d.view        = raw.data();
+        d.view_length = int(raw.size());
+        d.length      = int(raw.size());
+        (void) func(d, ctx, decoded.get());
+        return decoded.get();
+    }
+};
+
+// decoded value of an optional lazy IE, nullptr when absent
+template < typename element_t, dissect_func_t< element_t > func >
+const element_t* lazy_ie(const opt_t< lazy_t< element_t, func > >& ie,
+                         context*                                  ctx = nullptr) {
+    return ie.present ? ie.v.get(ctx) : nullptr;
+}
+
 result_t de_t_uint16(dissector d, context* ctx, uint8_t ieid, opt_t< uint16_t >* ret);
 
 result_t de_tl_uint16(dissector d, context* ctx, uint8_t ieid, opt_t< uint16_t >* ret);
 
+template < typename element_t, dissect_func_t< element_t > func >
+result_t de_tl_octet(dissector                           d,
+                     context*                            ctx,
+                     uint8_t                             ieid,
+                     opt_t< lazy_t< element_t, func > >* ret) {
+    opt_t< octet_t > v = {};
+    const auto       r = de_tl_octet(d, ctx, ieid, &v);
+    ret->present       = v.present;
+    ret->v.raw         = std::move(v.v);
+    return r;
+}
+
+template < typename element_t, dissect_func_t< element_t > func >
+result_t de_tle_octet(dissector                           d,
+                      context*                            ctx,
+                      uint8_t                             ieid,
+                      opt_t< lazy_t< element_t, func > >* ret) {
+    opt_t< octet_t > v = {};
+    const auto       r = de_tle_octet(d, ctx, ieid, &v);
+    ret->present       = v.present;
+    ret->v.raw         = std::move(v.v);
+    return r;
+}
+
+template < typename element_t, dissect_func_t< element_t > func >
+result_t de_le_octet(dissector d, context* ctx, lazy_t< element_t, func >* ret) {
+    return de_le_octet(d, ctx, &ret->raw);
+}
+
 template < typename element_t >
 result_t de_l(dissector                   d,
               context*                    ctx,
               element_t*                  ret,
               dissect_func_t< element_t > func) {
-    auto length = d.uint8();
+    auto             length = d.uint8();
+    const mask_scope ms(ctx);
     (void) func(d.slice(length), ctx, ret);
 
     return {length + 1};
@@ -61,7 +120,8 @@ result_t de_t(dissector                   d,
     if (iei != ret->iei && ret->iei != 0xffu) return {0};
     ret->present = true;
 
-    auto consumed = func(d, ctx, &ret->v);
+    const mask_scope ms(ctx);
+    auto             consumed = func(d, ctx, &ret->v);
     return {consumed + 1};
 }
 
@@ -78,7 +138,8 @@ result_t de_tl(dissector                   d,
     if (iei != ret->iei && ret->iei != 0xffu) return {0};
     ret->present = true;
 
-    int length = d.uint8();
+    int              length = d.uint8();
+    const mask_scope ms(ctx);
     (void) func(d.slice(length), ctx, &ret->v);
     return {length + 2};
 }
@@ -104,6 +165,7 @@ result_t de_tel(dissector                   d,
         len = len & 0x7fu;
     d.step(len_length);
 
+    const mask_scope ms(ctx);
     (void) func(d.slice(len), ctx, &ret->v);
     return {1 + len_length + len};
 }
@@ -117,10 +179,12 @@ result_t de_tle(dissector                   d,
                 dissect_func_t< element_t > func) {
     auto iei = d.uint8();
     if (iei != ieid && ieid != 0xffu) return {0};
-    ret->present = true;
 
     const auto len = d.uint16();
+    if (!ie_selected(ctx, iei)) return {1 + 2 + len};
+    ret->present = true;
 
+    const mask_scope ms(ctx);
     (void) func(d.slice(len), ctx, &ret->v);
 
     return {1 + 2 + len};
@@ -132,18 +196,21 @@ result_t de_le(dissector                   d,
                context*                    ctx,
                opt_t< element_t >*         ret,
                dissect_func_t< element_t > func) {
-    ret->present   = true;
     const auto len = d.uint16();
+    if (!mandatory_ie_selected(ctx)) return {len + 2};
+    ret->present = true;
 
+    const mask_scope ms(ctx);
     (void) func(d.slice(len), ctx, &ret->v);
     return {len + 2};
 }
 
 template < typename E >
 result_t de_t_fixed(dissector d, context* ctx, uint8_t ieid, opt_t< E >* ret) {
-    auto ie      = d.uint8(true);
-    ret->present = ie == ieid || ieid == 0xffu;
+    auto ie = d.uint8(true);
     if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + sizeof(ret->v)};
+    ret->present = true;
     d.octet(ret->v, sizeof(ret->v));
 
     return {1 + sizeof(ret->v)};
@@ -154,6 +221,7 @@ result_t de_tl_fixed(dissector d, context* ctx, uint8_t ieid, opt_t< E >* ret) {
     auto ie  = d.uint8(true);
     auto len = d.uint8(true);
     if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + 1 + len};
 
     ret->present = true;
     d.octet(ret->v, d.safe_length(len > sizeof(ret->v) ? sizeof(ret->v) : len));
@@ -162,22 +230,24 @@ result_t de_tl_fixed(dissector d, context* ctx, uint8_t ieid, opt_t< E >* ret) {
 }
 
 template < typename Slice >
-result_t de_fixed(dissector d, context*, Slice ret) {
+result_t de_fixed(dissector d, context*, Slice& ret) {
     auto l = d.octet(ret, sizeof(ret));
     return {int(l)};
 }
 
 template < typename Slice >
-result_t de_le_fixed(dissector d, context*, Slice ret) {
+result_t de_le_fixed(dissector d, context* ctx, Slice& ret) {
     auto len = d.uint16(true);
+    if (!mandatory_ie_selected(ctx)) return {2 + len};
 
     auto l = d.octet(ret, sizeof(ret) > len ? len : sizeof(ret));
     return {2 + len};
 }
 
 template < typename Slice >
-result_t de_l_fixed(dissector d, context*, Slice ret) {
+result_t de_l_fixed(dissector d, context* ctx, Slice& ret) {
     auto len = d.uint8(true);
+    if (!mandatory_ie_selected(ctx)) return {1 + len};
 
     auto l = d.octet(ret, sizeof(ret) > len ? len : sizeof(ret));
     return {1 + len};
@@ -188,6 +258,7 @@ result_t de_tle_fixed(dissector d, context* ctx, uint8_t ieid, opt_t< E >* ret)
     auto ie  = d.uint8(true);
     auto len = d.uint16(true);
     if (ie != ieid && ieid != 0xffu) return {0};
+    if (!ie_selected(ctx, ie)) return {1 + 2 + len};
 
     ret->present = true;
     d.octet(ret->v, d.safe_length(len > sizeof(ret->v) ? sizeof(ret->v) : len));
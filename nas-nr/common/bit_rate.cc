@@ -0,0 +1,54 @@
+#include "bit_rate.hh"
+
+#include <cstdint>
+
+namespace {
+// kbps of the octet alone
+uint64_t eps_octet_kbps(uint8_t v) {
+    if (v == 0 || v == 0xff) return 0;
+    if (v < 0x40) return v;
+    if (v < 0x80) return 64 + (v - 0x40u) * 8;
+    return 576 + (v - 0x80u) * 64;
+}
+
+// kbps of the extended octet, 8700 kbps to 256 Mbps
+uint64_t eps_extended_kbps(uint8_t v) {
+    if (v <= 0x4a) return 8600 + v * 100u;
+    if (v <= 0xba) return 16000 + (v - 0x4au) * 1000;
+    if (v <= 0xfa) return 128000 + (v - 0xbau) * 2000;
+    return 256000;
+}
+} // namespace
+
+uint64_t eps_bit_rate_bps(uint8_t octet, uint8_t extended, uint8_t extended2) {
+    uint64_t kbps = eps_octet_kbps(octet);
+    if (extended != 0) kbps = eps_extended_kbps(extended);
+    if (extended2 != 0) {
+        // 260 Mbps to 10 Gbps
+        if (extended2 <= 0x3d)
+            kbps = 256000 + extended2 * 4000u;
+        else if (extended2 <= 0xa1)
+            kbps = 500000 + (extended2 - 0x3du) * 10000;
+        else if (extended2 <= 0xf6)
+            kbps = 1500000 + (extended2 - 0xa1u) * 100000;
+        else
+            kbps = 10000000;
+    }
+    return kbps * 1000;
+}
+
+uint64_t apn_ambr_bps(uint8_t octet, uint8_t extended, uint8_t extended2) {
+    uint64_t kbps = eps_octet_kbps(octet);
+    if (extended != 0) kbps = eps_extended_kbps(extended);
+    // extended-2 adds multiples of 256 Mbps
+    if (extended2 != 0 && extended2 != 0xff) kbps += extended2 * 256000u;
+    return kbps * 1000;
+}
+
+uint64_t eps_extended_bit_rate_bps(uint8_t unit, uint16_t value) {
+    if (unit == 0) return 0;
+    // 200 kbps, then 1 Mbps on as the 5GS units from 1 Mbps
+    if (unit == 1) return 200000u * value;
+    if (unit > 0x15) unit = 0x15;
+    return nr_bit_rate_bps(uint8_t(unit + 4), value);
+}
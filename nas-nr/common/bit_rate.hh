@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+
+/* Bit rates of the 5GS and EPS QoS IEs in bits per second. Results too large for 64
+ * bits saturate at UINT64_MAX. */
+
+constexpr uint64_t bps_add(uint64_t a, uint64_t b) {
+    return a + b < a ? UINT64_MAX : a + b;
+}
+constexpr uint64_t bps_sub(uint64_t a, uint64_t b) { return a > b ? a - b : 0; }
+constexpr uint64_t bps_mul(uint64_t a, uint64_t b) {
+    return a != 0 && b > UINT64_MAX / a ? UINT64_MAX : a * b;
+}
+
+// 9.11.4.14 units: 1 Kbps, 4 Kbps ... 256 Kbps, 1 Mbps ... 256 Pbps
+inline extern const uint8_t nr_bit_rate_unit_max = 0x19;
+
+struct nr_bit_rate_units {
+    uint64_t bps[nr_bit_rate_unit_max + 1] = {}; // bps[0] for the unit not used
+
+    constexpr nr_bit_rate_units() {
+        uint64_t decade = 1000;
+        for (int unit = 1; unit <= nr_bit_rate_unit_max; ++unit) {
+            bps[unit] = decade << (2u * ((unit - 1u) % 5u));
+            if (unit % 5 == 0) decade *= 1000;
+        }
+    }
+};
+inline constexpr nr_bit_rate_units nr_bit_rate_unit_table = {};
+
+// bps of one step of a unit, values past 256 Pbps are 256 Pbps as 9.11.4.14 says
+constexpr uint64_t nr_bit_rate_unit_bps(uint8_t unit) {
+    return nr_bit_rate_unit_table.bps[unit > nr_bit_rate_unit_max ? nr_bit_rate_unit_max
+                                                                  : unit];
+}
+
+// 9.11.4.14 unit and value, as GFBR, MFBR, Session-AMBR and Session-TMBR code them
+constexpr uint64_t nr_bit_rate_bps(uint8_t unit, uint16_t value) {
+    return bps_mul(nr_bit_rate_unit_bps(unit), value);
+}
+
+/* The inverse for encoding: the smallest unit whose value reaches bps, rounded up so
+ * the rate encoded is never below the one asked for. False when bps is past 65535 times
+ * 256 Pbps, then the largest rate is encoded. */
+constexpr bool nr_bit_rate_encode(uint64_t bps, uint8_t* unit, uint16_t* value) {
+    for (uint8_t u = 1; u <= nr_bit_rate_unit_max; ++u) {
+        const auto step = nr_bit_rate_unit_bps(u);
+        const auto n    = bps / step + (bps % step != 0 ? 1 : 0);
+        if (n <= 0xffff) {
+            *unit  = u;
+            *value = uint16_t(n);
+            return true;
+        }
+    }
+    *unit  = nr_bit_rate_unit_max;
+    *value = 0xffff;
+    return false;
+}
+
+/* TS 24.008 10.5.6.5 maximum or guaranteed bit rate octet and its extended and
+ * extended-2 octets (TS 24.301 9.9.4.3), 0 for an octet that is absent */
+uint64_t eps_bit_rate_bps(uint8_t octet, uint8_t extended = 0, uint8_t extended2 = 0);
+
+// TS 24.301 9.9.4.2 APN-AMBR octet with its extended and extended-2 octets
+uint64_t apn_ambr_bps(uint8_t octet, uint8_t extended = 0, uint8_t extended2 = 0);
+
+// TS 24.301 9.9.4.29 and 9.9.4.30 unit and value of the extended APN-AMBR and EPS QoS
+uint64_t eps_extended_bit_rate_bps(uint8_t unit, uint16_t value);
@@ -10,10 +10,13 @@ struct nr_security_context {
     int vector_index                    = 0; // pointer of vector, -1 means invalid
     uint8_t          cyphering_key[16]  = {};
     uint8_t          integrity_key[16]  = {};
+    uint8_t          kausf[32]          = {}; // 33.501 KAUSF, SOR and UPU MACs
     uint32_t dl_count_overflow          = 0; // downlink count parameters
     uint32_t dl_count_seq_no            = 0;
     uint32_t ul_count_overflow          = 0;
     uint32_t ul_count_seq_no            = 0;
+    bool     dl_count_seen              = false; // the COUNT above is a baseline
+    bool     ul_count_seen              = false;
     struct {
         uint8_t ciphering_nr   = 0; // ciphering algo for nr
         uint8_t integrity_nr   = 0; // integrity algo for nr
@@ -30,8 +33,14 @@ struct nr_security_context {
     } selected_algorithm;           // AMF selected algorithm
 };
 
+struct decode_mask;
+
 struct context : nr_security_context {
     bool                            security_context_available = false;
     uint8_t                         payload_content_type       = 0;
     std::vector< std::string >      paths                      = {};
+    const decode_mask*              mask                       = nullptr; // all IEs when null
+    int                             mask_message               = -1; // message type in decode
+    int                             n1_sm_depth_limit          = 0; // N1 SM payloads decoded
+    int                             n1_sm_depth                = 0; // in place, 0 keeps raw
 };
@@ -0,0 +1,44 @@
+#include "decode_mask.hh"
+
+#include "context.hh"
+
+decode_mask& decode_mask::select(uint8_t                           message_type,
+                                 std::initializer_list< uint8_t > ieis,
+                                 bool                              mandatory_ies) {
+    messages.set(message_type);
+    if (mandatory_ies) mandatory.set(message_type);
+    for (auto iei : ieis) optional[message_type].set(iei);
+    return *this;
+}
+
+decode_mask& decode_mask::select_all(uint8_t message_type) {
+    messages.set(message_type);
+    mandatory.set(message_type);
+    optional[message_type].set();
+    return *this;
+}
+
+bool message_selected(const context* ctx, uint8_t message_type) {
+    if (!ctx || !ctx->mask) return true;
+    return ctx->mask->messages.test(message_type);
+}
+
+bool ie_selected(const context* ctx, uint8_t iei) {
+    if (!ctx || !ctx->mask || ctx->mask_message < 0) return true;
+    return ctx->mask->optional[ctx->mask_message].test(iei);
+}
+
+bool mandatory_ie_selected(const context* ctx) {
+    if (!ctx || !ctx->mask || ctx->mask_message < 0) return true;
+    return ctx->mask->mandatory.test(ctx->mask_message);
+}
+
+mask_scope::mask_scope(context* ctx, int message_type) : ctx(ctx) {
+    if (!ctx) return;
+    message           = ctx->mask_message;
+    ctx->mask_message = message_type;
+}
+
+mask_scope::~mask_scope() {
+    if (ctx) ctx->mask_message = message;
+}
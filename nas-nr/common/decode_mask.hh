@@ -0,0 +1,45 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+
+struct context;
+
+/* Which IEs de_nas_message extracts, per message type, for jobs that read a couple of
+ * fields out of every message.
+ * Messages not selected are decoded up to their header only. In a selected message the
+ * V/TV fields of one octet or less are always set, optional IEs are extracted when their
+ * IEI is selected, and mandatory LV and LV-E IEs (mobile identity, payload container,
+ * EAP, ...) when mandatory_ies is selected. Everything else is skipped by its length and
+ * reads as absent (or empty). Decoders of IE contents are not affected. */
+struct decode_mask {
+    // e.g. select(0x41, {}, true) for the mobile identity of a registration request;
+    // type 1 IEs are selected by their IEI nibble, e.g. 0xb0 for MICO indication
+    decode_mask& select(uint8_t message_type, std::initializer_list< uint8_t > ieis = {},
+                        bool mandatory_ies = false);
+
+    // every IE of the message
+    decode_mask& select_all(uint8_t message_type);
+
+    std::bitset< 256 > messages      = {};
+    std::bitset< 256 > mandatory     = {};
+    std::bitset< 256 > optional[256] = {}; // by message type, then IEI
+};
+
+// how a decoder asks: true unless a mask of ctx leaves the message or IE out
+bool message_selected(const context* ctx, uint8_t message_type);
+bool ie_selected(const context* ctx, uint8_t iei);
+bool mandatory_ie_selected(const context* ctx);
+
+// sets the message the mask applies to for the life of the scope; decoders of IE
+// contents run with -1, which suspends the mask
+struct mask_scope {
+    explicit mask_scope(context* ctx, int message_type = -1);
+    ~mask_scope();
+
+    mask_scope(const mask_scope&) = delete;
+    mask_scope& operator=(const mask_scope&) = delete;
+
+    context* ctx     = nullptr;
+    int      message = -1;
+};
@@ -134,6 +134,7 @@ struct nas_message_protected_t {
     uint8_t             security_header_type = 0;  // 9.3
     octet_4             auth_code            = {}; // 9.8
     uint8_t             sequence_no          = 0;  // 9.10	Sequence number
+    uint32_t            count                = 0;  // NAS COUNT estimated from sequence_no
     nas_message_plain_t plain                = {}; // 9.9
 };
 
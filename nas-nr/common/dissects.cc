@@ -9,6 +9,8 @@
 #include "ies.hh"
 #include "messages.hh"
 #include "nas.hh"
+#include "nas_count.hh"
+#include "packet.hh"
 #include "protocol.hh"
 
 int result_t::step(dissector& d) const {
@@ -47,6 +49,10 @@ result_t de_nas_protected(dissector d, context* ctx, nas_message_protected_t* v)
     /* 9.10 Sequence number    octet 7 */
     v->sequence_no = d.uint8();
 
+    // security header type 3 and 4 come with a new 5G NAS security context
+    if (v->security_header_type == 3 || v->security_header_type == 4) reset_nas_count(ctx);
+    if (d.pinfo) (void) estimate_nas_count(ctx, d.pinfo->dir, v->sequence_no, &v->count);
+
     // TODO: decrypt the body
     // This should work when the NAS ciphering algorithm is NULL (128-EEA0)
     de_nas_plain(d, ctx, &v->plain).step(d);
@@ -91,7 +97,12 @@ result_t de_nsm_message(dissector d, context* ctx, nsm_message_t* v) {
     const use_context uc(&d, ctx, "session-management-message", 0);
 
     de_nsm_header(d, ctx, &v->header);
+    if (!message_selected(ctx, v->header.message_type)) {
+        d.step(d.length); // not selected, skip the body
+        return {uc.length};
+    }
 
+    const mask_scope ms(ctx, v->header.message_type);
     switch (v->header.message_type) {
         DISSECT(0xc1u, pdu_session_establishment_request);
         DISSECT(0xc2u, pdu_session_establishment_accept);
@@ -119,6 +130,12 @@ result_t de_nmm_message(dissector d, context* ctx, nmm_message_t* v) {
     const use_context uc(&d, ctx, "mobile-management-message", 0);
 
     de_nmm_header(d, ctx, &v->header);
+    if (!message_selected(ctx, v->header.message_type)) {
+        d.step(d.length); // not selected, skip the body
+        return {uc.length};
+    }
+
+    const mask_scope ms(ctx, v->header.message_type);
     switch(v->header.message_type){
         DISSECT(0x41, registration_request);
         DISSECT(0x42, registration_accept);
@@ -168,3 +185,95 @@ result_t de_nmm_header(dissector d, context* ctx, nmm_header_t* ret) {
     ret->message_type         = d.uint8();
     return {3};
 }
+
+namespace {
+// slots of the flat table triage_nas_batch() counts into
+const uint32_t slot_nmm     = 0;
+const uint32_t slot_nsm     = 256;
+const uint32_t slot_sht     = 512;
+const uint32_t slot_invalid  = 528;
+const uint32_t slot_none     = 529; // second slot of messages counted once
+const uint32_t slot_ciphered = 530; // 5GMM of unknown type, the plain message is ciphered
+const uint32_t slots         = 531;
+
+// triage_nas_batch() tables, so that runs of one message type do not serialize
+const size_t table_lanes = 4;
+
+// 9.8 MAC and 9.10 sequence number follow the outer header
+const int protected_header_length = 7;
+
+/* Both table slots a message counts in, packed low | high << 16.
+ * Written as straight line code over bounds checked loads so that batches keep
+ * several messages in flight. */
+inline uint32_t triage_slots(const uint8_t* p, int length, nas_triage_t* ret) {
+    auto at = [p, length](int i) -> uint32_t { return i < length ? p[i] : 0u; };
+
+    const auto epd = at(0);
+    if (epd == epd::nsm) {
+        if (length < 4) return slot_invalid | slot_none << 16u;
+        if (ret) *ret = {uint8_t(epd), 0, uint8_t(at(3)), uint8_t(at(1)), uint8_t(at(2))};
+        return (slot_nsm + at(3)) | slot_none << 16u;
+    }
+    if (epd != epd::nmm || length < 3) return slot_invalid | slot_none << 16u;
+
+    const auto sht = at(1) & 0x0fu;
+    if (sht > 4) return slot_invalid | slot_none << 16u;
+
+    // integrity protected and ciphered, the type is not readable without the keys
+    if (sht == 2 || sht == 4) {
+        if (length < protected_header_length) return slot_invalid | slot_none << 16u;
+        if (ret) *ret = {uint8_t(epd), uint8_t(sht), 0, 0, 0};
+        return slot_ciphered | (slot_sht + sht) << 16u;
+    }
+
+    // integrity protected only, the plain 5GMM message starts after the MAC and SQN
+    const int base = sht == 0 ? 0 : protected_header_length;
+    if (length < base + 3 || at(base) != epd::nmm) return slot_invalid | slot_none << 16u;
+
+    const auto type = at(base + 2);
+    if (ret) *ret = {uint8_t(epd), uint8_t(sht), uint8_t(type), 0, 0};
+    return (slot_nmm + type) | (slot_sht + sht) << 16u;
+}
+} // namespace
+
+bool triage_nas(const uint8_t* data, int length, nas_triage_t* ret) {
+    if (!data || length <= 0) return false;
+    return (triage_slots(data, length, ret) & 0xffffu) != slot_invalid;
+}
+
+void triage_nas_batch(const uint8_t* const* data,
+                      const int*            lengths,
+                      size_t                n,
+                      nas_triage_counters*  counters) {
+    const size_t lanes = table_lanes;
+    // messages per flush, below what a 32 bit count can hold
+    const size_t chunk = size_t(1) << 30u;
+
+    uint32_t table[table_lanes][slots] = {};
+    auto     count                     = [&](size_t l, size_t i) {
+        const auto s = data[i] ? triage_slots(data[i], lengths[i], nullptr)
+                               : slot_invalid | slot_none << 16u;
+        ++table[l][s & 0xffffu];
+        ++table[l][s >> 16u];
+    };
+
+    for (size_t begin = 0; begin < n; begin += chunk) {
+        const size_t end = n - begin > chunk ? begin + chunk : n;
+
+        size_t i = begin;
+        for (; i + lanes <= end; i += lanes)
+            for (size_t l = 0; l < lanes; ++l) count(l, i + l);
+        for (; i < end; ++i) count(0, i);
+
+        for (size_t l = 0; l < lanes; ++l) {
+            const auto* t = table[l];
+            for (uint32_t k = 0; k < 256; ++k) counters->nmm[k] += t[slot_nmm + k];
+            for (uint32_t k = 0; k < 256; ++k) counters->nsm[k] += t[slot_nsm + k];
+            for (uint32_t k = 0; k < 16; ++k)
+                counters->security_header[k] += t[slot_sht + k];
+            counters->ciphered += t[slot_ciphered];
+            counters->invalid += t[slot_invalid];
+        }
+        std::memset(table, 0, sizeof(table));
+    }
+}
@@ -1,12 +1,47 @@
 #pragma once
+#include <cstddef>
+
 #include "definitions.hh"
 
 result_t de_nmm_header(dissector d, context* ctx, nmm_header_t* ret);
 result_t de_nsm_header(dissector d, context* ctx, nsm_header_t* ret);
 
+// the headers of a message, read by triage_nas() without decoding the rest
+struct nas_triage_t {
+    uint8_t epd                  = 0; // of the plain message
+    uint8_t security_header_type = 0; // of the outer 5GMM header, 0 when plain
+    uint8_t message_type         = 0; // of the plain message, 0 when it is ciphered
+    uint8_t pdu_session_id       = 0; // 5GSM only
+    uint8_t pti                  = 0; // 5GSM only
+};
+
+/* Classifies a buffer by its headers only, looking through an integrity protected header
+ * at the plain message the way de_nas_protected() does; a ciphered one (security header
+ * type 2 or 4) only gives its security header type. Nothing is allocated.
+ * False when the buffer is too short or the EPD or security header type is unknown. */
+bool triage_nas(const uint8_t* data, int length, nas_triage_t* ret);
+
+// message counts by type, 5GMM messages are counted under their plain message type
+struct nas_triage_counters {
+    uint64_t nmm[256]            = {};
+    uint64_t nsm[256]            = {};
+    uint64_t security_header[16] = {}; // 5GMM by security header type, 0 for plain
+    uint64_t ciphered            = 0;  // 5GMM whose plain message type is ciphered
+    uint64_t invalid             = 0;
+};
+
+// triage_nas() over n buffers, adding to counters
+void triage_nas_batch(const uint8_t* const* data,
+                      const int*            lengths,
+                      size_t                n,
+                      nas_triage_counters*  counters);
+
 
 result_t de_nas_message(dissector d, context* ctx, nas_message_t* v);
 
+// decodes every lazy IE of msg up front, for jobs that read most of them
+void decode_lazy_ies(const nas_message_t& msg, context* ctx = nullptr);
+
 result_t de_nsm_message(dissector d, context* ctx, nsm_message_t* v);
 
 result_t de_nmm_message(dissector d, context* ctx, nmm_message_t* v);
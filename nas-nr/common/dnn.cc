@@ -1,5 +1,55 @@
-#include "dissector.hh"
-#include "nas.hh"
-#include "use_context.hh"
+#include "dnn.hh"
+
+#include <cstring>
+
+#include "intern.hh"
 
 /*  9.11.2.1A    DNN */
+
+int dnn_to_dotted(const uint8_t* dnn, int length, char* out, int capacity) {
+    if (!dnn || length <= 0 || length > dnn_max_length || length - 1 > capacity) return -1;
+
+    // the dotted form is the encoding shifted by one octet with every length but the
+    // first turned into a dot, so copy it all and patch one octet per label
+    std::memcpy(out, dnn + 1, size_t(length - 1));
+    int pos = 0, empty = 0;
+    while (pos < length) {
+        const int label = dnn[pos];
+        empty |= label == 0;
+        if (pos > 0) out[pos - 1] = '.';
+        pos += label + 1;
+    }
+    if (pos != length || empty) return -1;
+
+    if (length - 1 < capacity) out[length - 1] = '\0';
+    return length - 1;
+}
+
+int dnn_from_dotted(const char* dotted, int length, uint8_t* out, int capacity) {
+    if (!dotted || length <= 0 || length + 1 > dnn_max_length || length + 1 > capacity)
+        return -1;
+
+    // the mirror image: copy behind a length octet, then fill each label length in
+    std::memcpy(out + 1, dotted, size_t(length));
+    int start = 0; // length octet of the current label
+    for (int i = 1; i <= length + 1; ++i) {
+        if (i <= length && out[i] != '.') continue;
+        const int label = i - start - 1;
+        if (label == 0 || label > 63) return -1;
+        out[start] = uint8_t(label);
+        start      = i;
+    }
+    return length + 1;
+}
+
+uint16_t intern_dnn_dotted(const char* dotted, int length) {
+    uint8_t    dnn[dnn_max_length];
+    const auto n = dnn_from_dotted(dotted, length, dnn, sizeof(dnn));
+    return n > 0 ? intern_dnn(dnn, n) : 0;
+}
+
+int interned_dnn_dotted(uint16_t id, char* out, int capacity) {
+    const auto* dnn = interned_dnn(id);
+    if (!dnn) return -1;
+    return dnn_to_dotted(dnn->data(), int(dnn->size()), out, capacity);
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdint>
+
+/* 9.11.2.1A DNN, an APN encoded as in TS 23.003 9.1: length prefixed labels, at most 100
+ * octets. Conversions work on caller buffers and never allocate. */
+inline extern const int dnn_max_length = 100;
+
+// dotted form of a DNN into out, NUL terminated when there is room, its length without
+// the NUL, -1 when the labels do not add up or out is too small
+int dnn_to_dotted(const uint8_t* dnn, int length, char* out, int capacity);
+
+// label encoding of a dotted name, its length, -1 on an empty or over long label or when
+// out is too small
+int dnn_from_dotted(const char* dotted, int length, uint8_t* out, int capacity);
+
+// intern_dnn() of a dotted name, 0 when it does not encode
+uint16_t intern_dnn_dotted(const char* dotted, int length);
+
+// dotted form of an interned DNN, -1 for an unknown id
+int interned_dnn_dotted(uint16_t id, char* out, int capacity);
@@ -1,8 +1,178 @@
-#include "context.hh"
-#include "dissector.hh"
-#include "use_context.hh"
+#include "eap.hh"
+
+#include <cstring>
+
+#include <nettle/hmac.h>
 
 // RFC2284 RFC3748
 
 /* 9.11.2.2    EAP message*/
 
+namespace {
+uint16_t u16(const uint8_t* p) {
+    return uint16_t(p[0] << 8u | p[1]);
+}
+
+const int mac_length = 16; // AT_MAC value after its 2 reserved octets
+
+// HMAC over data with the 16 octets at mac taken as zeros, then extra
+template < typename ctx_t, typename update_t >
+void hmac_masked(ctx_t*         ctx,
+                 update_t       update,
+                 const uint8_t* data,
+                 int            length,
+                 const uint8_t* mac,
+                 const uint8_t* extra,
+                 int            extra_length) {
+    static const uint8_t zeros[mac_length] = {};
+    const auto           before            = size_t(mac - data);
+    update(ctx, before, data);
+    update(ctx, mac_length, zeros);
+    update(ctx, size_t(length) - before - mac_length, mac + mac_length);
+    if (extra_length > 0) update(ctx, size_t(extra_length), extra);
+}
+
+// compares every octet, so the time taken does not depend on where they differ
+bool same_mac(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (auto i = 0; i < mac_length; ++i) diff |= uint8_t(a[i] ^ b[i]);
+    return diff == 0;
+}
+} // namespace
+
+bool parse_eap(const uint8_t* data, int length, eap_view* ret) {
+    if (!data || length < 4) return false;
+
+    const int declared = u16(data + 2);
+    if (declared < 4 || declared > length) return false;
+
+    *ret            = {};
+    ret->data       = data;
+    ret->length     = declared;
+    ret->code       = data[0];
+    ret->identifier = data[1];
+    if (ret->code != eap_code::request && ret->code != eap_code::response) return true;
+    if (declared < 5) return false;
+
+    ret->type = data[4];
+    if (ret->type != eap_type::aka && ret->type != eap_type::aka_prime) return true;
+
+    // RFC 4187 8.1 subtype and two reserved octets precede the attributes
+    if (declared < 8) return false;
+    ret->subtype           = data[5];
+    ret->attributes        = data + 8;
+    ret->attributes_length = declared - 8;
+    return true;
+}
+
+bool parse_eap(const octet_t& eap, eap_view* ret) {
+    return parse_eap(eap.data(), int(eap.size()), ret);
+}
+
+bool eap_attribute_iterator::next(eap_attribute* ret) {
+    if (left < 4 || !p) return false;
+
+    // RFC 4187 8.1 length is in multiples of 4 octets and counts type and length
+    const int length = p[1] * 4;
+    if (length == 0 || length > left) {
+        left = 0;
+        return false;
+    }
+    ret->type   = p[0];
+    ret->value  = p + 2;
+    ret->length = length - 2;
+    p += length;
+    left -= length;
+    return true;
+}
+
+bool eap_find_attribute(const eap_view& v, uint8_t type, eap_attribute* ret) {
+    eap_attribute_iterator it(v);
+    while (it.next(ret))
+        if (ret->type == type) return true;
+    return false;
+}
+
+void eap_aka_parse(const eap_view& v, eap_aka_fields* ret) {
+    namespace at = eap_aka_attribute;
+    *ret         = {};
+
+    eap_attribute_iterator it(v);
+    eap_attribute          a;
+    while (it.next(&a)) {
+        const auto* p = a.value;
+        switch (a.type) {
+        case at::at_rand:
+            if (a.length >= 18) ret->rand = p + 2;
+            break;
+        case at::at_autn:
+            if (a.length >= 18) ret->autn = p + 2;
+            break;
+        case at::at_mac:
+            if (a.length >= 18) ret->mac = p + 2;
+            break;
+        case at::at_auts:
+            if (a.length >= 14) ret->auts = p;
+            break;
+        case at::at_res: // RES length in bits
+            if (a.length >= 2 && (u16(p) + 7) / 8 <= a.length - 2) {
+                ret->res      = p + 2;
+                ret->res_bits = u16(p);
+            }
+            break;
+        case at::at_kdf_input: // actual network name length
+            if (a.length >= 2 && u16(p) <= a.length - 2) {
+                ret->kdf_input        = p + 2;
+                ret->kdf_input_length = u16(p);
+            }
+            break;
+        case at::at_kdf:
+            if (a.length >= 2 && ret->kdfs++ == 0) ret->kdf = u16(p);
+            break;
+        case at::at_checkcode: // empty, 20 or 32 octets after 2 reserved
+            ret->checkcode        = p + 2;
+            ret->checkcode_length = a.length - 2;
+            break;
+        case at::at_result_ind:
+            ret->result_ind = true;
+            break;
+        case at::at_client_error_code:
+            if (a.length >= 2) ret->client_error_code = u16(p);
+            break;
+        case at::at_notification:
+            if (a.length >= 2) ret->notification = u16(p);
+            break;
+        default:
+            break;
+        }
+    }
+    ret->malformed = it.left != 0;
+}
+
+bool eap_aka_verify_mac(const eap_view& v,
+                        const uint8_t*  k_aut,
+                        int             k_aut_length,
+                        const uint8_t*  extra,
+                        int             extra_length) {
+    if (!k_aut || k_aut_length <= 0) return false;
+
+    eap_attribute a;
+    if (!eap_find_attribute(v, eap_aka_attribute::at_mac, &a) || a.length < 18) return false;
+    const auto* mac = a.value + 2;
+
+    uint8_t digest[mac_length];
+    if (v.type == eap_type::aka_prime) {
+        hmac_sha256_ctx ctx;
+        hmac_sha256_set_key(&ctx, size_t(k_aut_length), k_aut);
+        hmac_masked(&ctx, hmac_sha256_update, v.data, v.length, mac, extra, extra_length);
+        hmac_sha256_digest(&ctx, mac_length, digest);
+    } else if (v.type == eap_type::aka) {
+        hmac_sha1_ctx ctx;
+        hmac_sha1_set_key(&ctx, size_t(k_aut_length), k_aut);
+        hmac_masked(&ctx, hmac_sha1_update, v.data, v.length, mac, extra, extra_length);
+        hmac_sha1_digest(&ctx, mac_length, digest);
+    } else {
+        return false;
+    }
+    return same_mac(digest, mac);
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <cstdint>
+
+#include "definitions.hh"
+
+// RFC 3748 4.1 code
+namespace eap_code {
+inline extern const uint8_t request  = 1;
+inline extern const uint8_t response = 2;
+inline extern const uint8_t success  = 3;
+inline extern const uint8_t failure  = 4;
+} // namespace eap_code
+
+// RFC 3748 5 method type
+namespace eap_type {
+inline extern const uint8_t identity     = 1;
+inline extern const uint8_t notification = 2;
+inline extern const uint8_t nak          = 3;
+inline extern const uint8_t aka          = 23; // RFC 4187
+inline extern const uint8_t aka_prime    = 50; // RFC 5448, RFC 9048
+} // namespace eap_type
+
+// RFC 4187 11 EAP-AKA subtype
+namespace eap_aka_subtype {
+inline extern const uint8_t challenge               = 1;
+inline extern const uint8_t authentication_reject   = 2;
+inline extern const uint8_t synchronization_failure = 4;
+inline extern const uint8_t identity                = 5;
+inline extern const uint8_t notification            = 12;
+inline extern const uint8_t reauthentication        = 13;
+inline extern const uint8_t client_error            = 14;
+} // namespace eap_aka_subtype
+
+// RFC 4187 11 and RFC 9048 attribute types, skippable from 128 on
+namespace eap_aka_attribute {
+inline extern const uint8_t at_rand              = 1;
+inline extern const uint8_t at_autn              = 2;
+inline extern const uint8_t at_res               = 3;
+inline extern const uint8_t at_auts              = 4;
+inline extern const uint8_t at_padding           = 6;
+inline extern const uint8_t at_permanent_id_req  = 10;
+inline extern const uint8_t at_mac               = 11;
+inline extern const uint8_t at_notification      = 12;
+inline extern const uint8_t at_any_id_req        = 13;
+inline extern const uint8_t at_identity          = 14;
+inline extern const uint8_t at_fullauth_id_req   = 17;
+inline extern const uint8_t at_counter           = 19;
+inline extern const uint8_t at_counter_too_small = 20;
+inline extern const uint8_t at_nonce_s           = 21;
+inline extern const uint8_t at_client_error_code = 22;
+inline extern const uint8_t at_kdf_input         = 23;
+inline extern const uint8_t at_kdf               = 24;
+inline extern const uint8_t at_iv                = 129;
+inline extern const uint8_t at_encr_data         = 130;
+inline extern const uint8_t at_next_pseudonym    = 132;
+inline extern const uint8_t at_next_reauth_id    = 133;
+inline extern const uint8_t at_checkcode         = 134;
+inline extern const uint8_t at_result_ind        = 135;
+inline extern const uint8_t at_bidding           = 136;
+} // namespace eap_aka_attribute
+
+/* One EAP packet seen in place, pointers refer to the buffer given to parse_eap() and
+ * are only valid while it is. */
+struct eap_view {
+    const uint8_t* data              = nullptr; // code octet
+    int            length            = 0;       // from the length field
+    uint8_t        code              = 0;
+    uint8_t        identifier        = 0;
+    uint8_t        type              = 0; // request and response only
+    uint8_t        subtype           = 0; // EAP-AKA and EAP-AKA' only
+    const uint8_t* attributes        = nullptr;
+    int            attributes_length = 0;
+};
+
+// type and value of one attribute, value follows the type and length octets
+struct eap_attribute {
+    uint8_t        type   = 0;
+    const uint8_t* value  = nullptr;
+    int            length = 0;
+};
+
+// walks the attributes of an EAP-AKA or EAP-AKA' packet, false at the end or on a
+// malformed attribute
+struct eap_attribute_iterator {
+    const uint8_t* p    = nullptr;
+    int            left = 0;
+
+    explicit eap_attribute_iterator(const eap_view& v)
+        : p(v.attributes), left(v.attributes_length) {}
+    bool next(eap_attribute* ret);
+};
+
+// fields of an EAP-AKA or EAP-AKA' packet, views into it, nullptr when absent
+struct eap_aka_fields {
+    const uint8_t* rand              = nullptr; // 16 octets
+    const uint8_t* autn              = nullptr; // 16 octets
+    const uint8_t* auts              = nullptr; // 14 octets
+    const uint8_t* mac               = nullptr; // 16 octets
+    const uint8_t* res               = nullptr;
+    int            res_bits          = 0;
+    const uint8_t* kdf_input         = nullptr; // network name
+    int            kdf_input_length  = 0;
+    uint16_t       kdf               = 0; // first AT_KDF, the one in use
+    int            kdfs              = 0; // AT_KDF offered
+    const uint8_t* checkcode         = nullptr;
+    int            checkcode_length  = 0;
+    bool           result_ind        = false;
+    uint16_t       client_error_code = 0;
+    uint16_t       notification      = 0;
+    bool           malformed         = false; // attributes ended early
+};
+
+// false when data is too short for the header or the length it declares
+bool parse_eap(const uint8_t* data, int length, eap_view* ret);
+bool parse_eap(const octet_t& eap, eap_view* ret); // 9.11.2.2 EAP message contents
+
+// finds the first attribute of a type
+bool eap_find_attribute(const eap_view& v, uint8_t type, eap_attribute* ret);
+
+void eap_aka_parse(const eap_view& v, eap_aka_fields* ret);
+
+/* Checks AT_MAC of an EAP-AKA or EAP-AKA' packet with K_aut: HMAC-SHA1-128 and a 16
+ * octet key for EAP-AKA, HMAC-SHA-256-128 and a 32 octet key for EAP-AKA'. The packet is
+ * hashed in place with the MAC value taken as zeros (RFC 4187 10.15), extra is appended
+ * to the packet as the protocol requires, e.g. NONCE_S for re-authentication. */
+bool eap_aka_verify_mac(const eap_view& v,
+                        const uint8_t*  k_aut,
+                        int             k_aut_length,
+                        const uint8_t*  extra        = nullptr,
+                        int             extra_length = 0);
@@ -68,6 +68,7 @@ struct s_nssai_t {
     opt_t< octet_3 > sd               = {}; // SD	octet 4-6*
     opt_t< uint8_t > mapped_hplmn_sst = {}; // Mapped HPLMN SST	octet 7*
     opt_t< octet_3 > mapped_hplmn_sd  = {}; // Mapped HPLMN SD	octet 8-10*
+    uint16_t         id               = {}; // intern_s_nssai()
 };
 
 /* 9.11.2.9
@@ -142,6 +143,7 @@ using nid_type_t = bit_3;
 struct mcc_mnc_t {
     uint16_t mcc; //
     uint16_t mnc; //
+    uint16_t id;  // intern_plmn()
 };
 
 /*
@@ -365,17 +367,17 @@ struct partial_tai_list_00_t {
     std::vector< o3_t > taces  = {}; //
 };
 
+// number + 1 consecutive TACs starting at tac, only the first is encoded
 struct partial_tai_list_01_t {
-    bit_5               number = {}; // +1
-    bit_2               type   = {}; // 01
-    mcc_mnc_t           mccmnc = {}; //
-    octet_3             tac    = {}; //
-    std::vector< o3_t > others = {};
+    bit_5     number = {}; // +1
+    bit_2     type   = {}; // 01
+    mcc_mnc_t mccmnc = {}; //
+    octet_3   tac    = {}; //
 };
 
 struct partial_tai_list_10_t {
     bit_5                                number = {}; // +1
-    bit_2                                type   = {}; // 01
+    bit_2                                type   = {}; // 10
     std::vector< nr_tracking_area_id_t > ids    = {}; //
 };
 
@@ -678,13 +680,30 @@ Length of criteria	octet 7
 Criteria	octet 8  octet a-1
 0 Spare	Standardized access category	octet a*
 */
+
+// criteria types of figure 9.11.3.38.3, a count and then that many values
+namespace access_category_criteria {
+inline extern const uint8_t dnn             = 0x00; // length and DNN
+inline extern const uint8_t os_id_os_app_id = 0x01; // OS Id (16), length, OS App Id
+inline extern const uint8_t s_nssai         = 0x02; // length and S-NSSAI
+} // namespace access_category_criteria
+
+// criteria components decoded, the values of a type match when any one does
+struct access_category_criteria_t {
+    uint8_t                 types       = {}; // bit n set for a component of type n
+    std::vector< uint16_t > dnn_ids     = {}; // intern_dnn()
+    std::vector< uint16_t > s_nssai_ids = {}; // intern_s_nssai_octets()
+    std::vector< octet_t >  os_apps     = {}; // OS Id (16), then the OS App Id
+};
+
 struct operator_defined_access_category_definition_t {
-    uint8_t        precedence;                   //
-    bit_5          number;                       //
-    bit_2          spare;                        //
-    bit_1          psac;                         //
-    octet_t        criteria;                     //
-    opt_t< bit_5 > standardized_access_category; //
+    uint8_t                    precedence;                   //
+    bit_5                      number;                       //
+    bit_2                      spare;                        //
+    bit_1                      psac;                         //
+    octet_t                    criteria;                     //
+    opt_t< bit_5 >             standardized_access_category; //
+    access_category_criteria_t components;                   // criteria decoded
 };
 
 struct operator_defined_access_category_definitions_t {
@@ -1050,6 +1069,7 @@ struct sor_transparent_container_t {
         bit_1 ack;           //
     } header;
 
+    uint8_t                                     header_octet;      // as received
     octet_g                                     maci;              //
     uint16_t                                    counter;           //
     std::shared_ptr< octet_t >                  packet;            // plmn-id
@@ -1278,8 +1298,8 @@ using allowed_ssc_mode_t = bit_3;
 // 10.5.6.3A ts24008-16.10
 struct extended_pco_t {
     struct option_t {
-        uint8_t id      = {}; //
-        octet_t content = {}; //
+        uint16_t id      = {}; // protocol or container identifier
+        octet_t  content = {}; //
     };
 
     bit_3                   configuration_protocol = {}; //
@@ -1300,6 +1320,31 @@ struct integrity_protection_maximum_data_rate_t {
     uint8_t downlink = {}; //
 };
 
+// 9.11.4.8 parameter identifiers of a mapped EPS bearer context
+namespace mapped_eps_parameter {
+inline extern const uint8_t eps_qos          = 0x01; // TS 24.301 9.9.4.3
+inline extern const uint8_t extended_eps_qos = 0x02; // TS 24.301 9.9.4.30
+inline extern const uint8_t tft              = 0x03; // TS 24.008 10.5.6.12
+inline extern const uint8_t apn_ambr         = 0x04; // TS 24.301 9.9.4.2
+inline extern const uint8_t extended_ambr    = 0x05; // TS 24.301 9.9.4.29
+} // namespace mapped_eps_parameter
+
+// the parameters of one mapped EPS bearer context, bit rates in bps, 56 bytes
+struct eps_bearer_record_t {
+    uint64_t mbr_ul      = 0;
+    uint64_t mbr_dl      = 0;
+    uint64_t gbr_ul      = 0;
+    uint64_t gbr_dl      = 0;
+    uint64_t apn_ambr_ul = 0;
+    uint64_t apn_ambr_dl = 0;
+    uint8_t  ebi         = 0;
+    uint8_t  opcode      = 0;
+    uint8_t  qci         = 0;
+    uint8_t  tft_opcode  = 0; // TFT operation code
+    uint8_t  tft_filters = 0; // number of packet filters of the TFT
+    uint8_t  present     = 0; // bit n for parameter identifier n
+};
+
 // 9.11.4.8 Mapped EPS bearer contexts
 struct mapped_eps_bearer_contexts_t {
     struct parameter_t {
@@ -1307,13 +1352,14 @@ struct mapped_eps_bearer_contexts_t {
         octet_t content = {}; //
     };
     struct context_t {
-        uint8_t id = {}; //
-        // uint8_t length;
+        uint8_t                    id             = {}; // EPS bearer identity
+        uint16_t                   length         = {}; //
         bit_4                      parameters_n   = {}; //
         bit_1                      ebit           = {}; //
         bit_1                      spare          = {}; //
         bit_2                      operation_code = {}; //
         std::vector< parameter_t > parameters     = {}; //
+        eps_bearer_record_t        record         = {}; // parameters decoded
     };
 
     std::vector< context_t > contexts = {}; //
@@ -1373,6 +1419,30 @@ using pdu_session_type_t = bit_3;
   Length of parameter contents	octet 8
   Parameter contents	octet 9  octet m
 */
+namespace qos_flow_parameter {
+inline extern const uint8_t five_qi          = 0x01;
+inline extern const uint8_t gfbr_ul          = 0x02;
+inline extern const uint8_t gfbr_dl          = 0x03;
+inline extern const uint8_t mfbr_ul          = 0x04;
+inline extern const uint8_t mfbr_dl          = 0x05;
+inline extern const uint8_t averaging_window = 0x06;
+inline extern const uint8_t eps_bearer_id    = 0x07;
+} // namespace qos_flow_parameter
+
+// the parameters of one QoS flow description, bit rates in bps, 48 bytes
+struct qos_flow_record_t {
+    uint64_t gfbr_ul          = 0;
+    uint64_t gfbr_dl          = 0;
+    uint64_t mfbr_ul          = 0;
+    uint64_t mfbr_dl          = 0;
+    uint32_t averaging_window = 0; // ms
+    uint16_t present          = 0; // bit n for parameter identifier n
+    uint8_t  qfi              = 0;
+    uint8_t  opcode           = 0;
+    uint8_t  five_qi          = 0;
+    uint8_t  ebi              = 0;
+};
+
 struct qos_flow_descriptions_t {
     struct parameter_t {
         uint8_t id      = {}; //
@@ -1383,6 +1453,7 @@ struct qos_flow_descriptions_t {
         bit_3                      opcode     = {}; //
         bit_1                      ebit       = {}; //
         std::vector< parameter_t > parameters = {}; //
+        qos_flow_record_t          record     = {}; // parameters decoded
     };
     std::vector< entry_t > descs = {}; //
 };
@@ -1390,6 +1461,100 @@ struct qos_flow_descriptions_t {
 using qos_flow_description_parameter_t = qos_flow_descriptions_t::parameter_t;
 using qos_flow_description_t           = qos_flow_descriptions_t::entry_t;
 
+/*
+Table 9.11.4.13.1: QoS rules information element, packet filter component type identifier
+00000001	Match-all type
+00010000	IPv4 remote address type
+00010001	IPv4 local address type
+00100001	IPv6 remote address/prefix length type
+00100011	IPv6 local address/prefix length type
+00110000	Protocol identifier/Next header type
+01000000	Single local port type
+01000001	Local port range type
+01010000	Single remote port type
+01010001	Remote port range type
+01100000	Security parameter index type
+01110000	Type of service/Traffic class type
+10000000	Flow label type
+10000001	Destination MAC address type
+10000010	Source MAC address type
+10000011	802.1Q C-TAG VID type
+10000100	802.1Q S-TAG VID type
+10000101	802.1Q C-TAG PCP/DEI type
+10000110	802.1Q S-TAG PCP/DEI type
+10000111	Ethertype type
+10001000	Destination MAC address range type
+10001001	Source MAC address range type
+*/
+namespace packet_filter_component {
+inline extern const uint8_t match_all         = 0x01;
+inline extern const uint8_t ipv4_remote       = 0x10;
+inline extern const uint8_t ipv4_local        = 0x11;
+inline extern const uint8_t ipv6_remote       = 0x21;
+inline extern const uint8_t ipv6_local        = 0x23;
+inline extern const uint8_t protocol          = 0x30;
+inline extern const uint8_t local_port        = 0x40;
+inline extern const uint8_t local_port_range  = 0x41;
+inline extern const uint8_t remote_port       = 0x50;
+inline extern const uint8_t remote_port_range = 0x51;
+inline extern const uint8_t spi               = 0x60;
+inline extern const uint8_t tos               = 0x70;
+inline extern const uint8_t flow_label        = 0x80;
+inline extern const uint8_t dst_mac           = 0x81;
+inline extern const uint8_t src_mac           = 0x82;
+inline extern const uint8_t ctag_vid          = 0x83;
+inline extern const uint8_t stag_vid          = 0x84;
+inline extern const uint8_t ctag_pcp_dei      = 0x85;
+inline extern const uint8_t stag_pcp_dei      = 0x86;
+inline extern const uint8_t ethertype         = 0x87;
+inline extern const uint8_t dst_mac_range     = 0x88;
+inline extern const uint8_t src_mac_range     = 0x89;
+} // namespace packet_filter_component
+
+// packet filter contents, single ports and MAC addresses are ranges of one
+struct packet_filter_components_t {
+    struct ipv4_t {
+        octet_4 address = {}; //
+        octet_4 mask    = {}; //
+    };
+    struct ipv6_t {
+        octet_g address       = {}; //
+        uint8_t prefix_length = {}; //
+    };
+    struct port_range_t {
+        uint16_t low  = {}; //
+        uint16_t high = {}; //
+    };
+    struct tos_t {
+        uint8_t value = {}; //
+        uint8_t mask  = {}; //
+    };
+    struct mac_range_t {
+        octet_6 low  = {}; //
+        octet_6 high = {}; //
+    };
+
+    bit_1                 match_all    = {}; //
+    opt_t< ipv4_t >       ipv4_remote  = {}; //
+    opt_t< ipv4_t >       ipv4_local   = {}; //
+    opt_t< ipv6_t >       ipv6_remote  = {}; //
+    opt_t< ipv6_t >       ipv6_local   = {}; //
+    opt_t< uint8_t >      protocol     = {}; // protocol identifier / next header
+    opt_t< port_range_t > local_port   = {}; //
+    opt_t< port_range_t > remote_port  = {}; //
+    opt_t< uint32_t >     spi          = {}; //
+    opt_t< tos_t >        tos          = {}; // type of service / traffic class
+    opt_t< uint32_t >     flow_label   = {}; // 20 bits
+    opt_t< mac_range_t >  dst_mac      = {}; //
+    opt_t< mac_range_t >  src_mac      = {}; //
+    opt_t< uint16_t >     ctag_vid     = {}; // 12 bits
+    opt_t< uint16_t >     stag_vid     = {}; // 12 bits
+    opt_t< uint8_t >      ctag_pcp_dei = {}; // 4 bits
+    opt_t< uint8_t >      stag_pcp_dei = {}; // 4 bits
+    opt_t< uint16_t >     ethertype    = {}; //
+    uint8_t               unknown_type = {}; // where parsing stopped, 0 when it did not
+};
+
 // 9.11.4.13	QoS rules
 struct qos_rule_t {
     struct packet_filter_delete_t {
@@ -1397,10 +1562,10 @@ struct qos_rule_t {
         bit_4 spare = {}; //
     };
     struct packet_filter_add_t {
-        bit_4   id        = {}; //
-        bit_2   direction = {}; //
-        octet_t content   = {}; //
-        // uint8_t length;
+        bit_4                      id         = {}; //
+        bit_2                      direction  = {}; // 01 downlink, 10 uplink, 11 both
+        octet_t                    content    = {}; //
+        packet_filter_components_t components = {}; // decoded content
     };
     struct packet_filter_t {
         std::shared_ptr< packet_filter_add_t >    add  = {};
@@ -1424,6 +1589,16 @@ using qos_rule_packet_filter_delete_t = qos_rule_t::packet_filter_delete_t;
 using qos_rule_packet_filter_add_t    = qos_rule_t::packet_filter_add_t;
 using qos_rule_packet_filter_t        = qos_rule_t::packet_filter_t;
 
+// 9.11.4.13 rule operation code
+namespace qos_rule_operation {
+inline extern const uint8_t create                 = 1;
+inline extern const uint8_t remove                 = 2; // delete existing QoS rule
+inline extern const uint8_t add_packet_filters     = 3;
+inline extern const uint8_t replace_packet_filters = 4;
+inline extern const uint8_t delete_packet_filters  = 5;
+inline extern const uint8_t modify_keep_filters    = 6; // without modifying filters
+} // namespace qos_rule_operation
+
 struct qos_rules_t {
     std::vector< qos_rule_t > rules = {}; //
 };
@@ -1443,6 +1618,8 @@ struct session_ambr_t {
     uint16_t downlink      = {}; //
     uint8_t  uplink_unit   = {}; //
     uint16_t uplink        = {}; //
+    uint64_t downlink_bps  = {}; // nr_bit_rate_bps()
+    uint64_t uplink_bps    = {}; //
 };
 
 /* 9.11.4.15	SM PDU DN request container
@@ -1498,6 +1675,8 @@ struct session_tmbr_t {
     uint16_t downlink      = {}; //
     uint8_t  uplink_unit   = {}; //
     uint16_t uplink        = {}; //
+    uint64_t downlink_bps  = {}; // nr_bit_rate_bps()
+    uint64_t uplink_bps    = {}; //
 };
 
 // 9.11.4.20	Serving PLMN rate control
@@ -1538,3 +1717,58 @@ using control_plane_only_indication_t = bit_1;
 
 result_t die_nr_tracking_area_id(dissector d, context* ctx, nr_tracking_area_id_t* ret);
 result_t die_mcc_mnc(dissector d, context* ctx, mcc_mnc_t* ret);
+
+result_t die_nmm_capability(dissector d, context* ctx, nmm_capability_t* ret);
+result_t die_s_nssai(dissector d, context* ctx, s_nssai_t* ret);
+result_t die_nssai(dissector d, context* ctx, nssai_t* ret);
+result_t die_rejected_nssai(dissector d, context* ctx, rejected_nssai_t* ret);
+result_t die_pdu_session_status(dissector d, context* ctx, pdu_session_status_t* ret);
+result_t die_uplink_data_status(dissector d, context* ctx, uplink_data_status_t* ret);
+result_t die_nr_tracking_id_list(dissector                   d,
+                                 context*                    ctx,
+                                 nr_tracking_area_id_list_t* ret);
+result_t die_service_area_list(dissector d, context* ctx, service_area_list_t* ret);
+result_t die_nr_network_feature_support(dissector                     d,
+                                        context*                      ctx,
+                                        nr_network_feature_support_t* ret);
+result_t die_packet_filter_components(dissector                   d,
+                                      context*                    ctx,
+                                      packet_filter_components_t* ret);
+result_t die_qos_rule(dissector d, context* ctx, qos_rule_t* ret);
+result_t die_qos_rules(dissector d, context* ctx, qos_rules_t* ret);
+result_t die_mapped_eps_bearer_contexts(dissector                     d,
+                                        context*                      ctx,
+                                        mapped_eps_bearer_contexts_t* ret);
+result_t die_qos_flow_descriptions(dissector d, context* ctx, qos_flow_descriptions_t* ret);
+result_t die_extended_pco(dissector d, context* ctx, extended_pco_t* ret);
+result_t die_operator_defined_access_category_definitions(
+    dissector                                       d,
+    context*                                        ctx,
+    operator_defined_access_category_definitions_t* ret);
+result_t die_session_ambr(dissector d, context* ctx, session_ambr_t* ret);
+result_t die_session_tmbr(dissector d, context* ctx, session_tmbr_t* ret);
+
+// Session-AMBR contents the messages keep as octet_6
+session_ambr_t session_ambr(const octet_6& contents);
+result_t die_sor_transparent_container(dissector                    d,
+                                       context*                     ctx,
+                                       sor_transparent_container_t* ret);
+
+// IEs the messages keep raw, decoded on first access
+using lazy_nmm_capability_t     = lazy_t< nmm_capability_t, die_nmm_capability >;
+using lazy_nssai_t              = lazy_t< nssai_t, die_nssai >;
+using lazy_rejected_nssai_t     = lazy_t< rejected_nssai_t, die_rejected_nssai >;
+using lazy_pdu_session_status_t = lazy_t< pdu_session_status_t, die_pdu_session_status >;
+using lazy_uplink_data_status_t = lazy_t< uplink_data_status_t, die_uplink_data_status >;
+using lazy_service_area_list_t  = lazy_t< service_area_list_t, die_service_area_list >;
+using lazy_qos_rules_t          = lazy_t< qos_rules_t, die_qos_rules >;
+using lazy_tai_list_t = lazy_t< nr_tracking_area_id_list_t, die_nr_tracking_id_list >;
+using lazy_nr_network_feature_support_t =
+    lazy_t< nr_network_feature_support_t, die_nr_network_feature_support >;
+using lazy_mapped_eps_bearer_contexts_t =
+    lazy_t< mapped_eps_bearer_contexts_t, die_mapped_eps_bearer_contexts >;
+using lazy_qos_flow_descriptions_t =
+    lazy_t< qos_flow_descriptions_t, die_qos_flow_descriptions >;
+using lazy_access_category_definitions_t =
+    lazy_t< operator_defined_access_category_definitions_t,
+            die_operator_defined_access_category_definitions >;
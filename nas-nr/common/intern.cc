@@ -0,0 +1,142 @@
+#include "intern.hh"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace {
+uint64_t fnv1a(const uint8_t* p, size_t n, uint64_t h = 0xcbf29ce484222325ULL) {
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ULL;
+    return h;
+}
+
+void set_id(mcc_mnc_t* v, uint16_t id) {
+    v->id = id;
+}
+void set_id(s_nssai_t* v, uint16_t id) {
+    v->id = id;
+}
+void set_id(dnn_t*, uint16_t) {}
+
+/* Values live in a fixed array indexed by id - 1 and are written before their id is
+ * published, with release, into the hash slots and count; readers load with acquire and
+ * so always see a complete value. */
+template < typename T, uint32_t N > struct intern_table {
+    static const uint32_t slots = N * 2; // N is a power of two, keeps probing short
+
+    std::unique_ptr< T[] >                       values{new T[N]()};
+    std::unique_ptr< std::atomic< uint32_t >[] > ids{new std::atomic< uint32_t >[slots]()};
+    std::atomic< uint32_t >                      count{0};
+    std::mutex                                   mutex;
+
+    template < typename Eq > uint32_t find(uint64_t hash, Eq eq, uint32_t* free) const {
+        auto i = uint32_t(hash) & (slots - 1);
+        for (uint32_t probes = 0; probes < slots; ++probes, i = (i + 1) & (slots - 1)) {
+            const auto id = ids[i].load(std::memory_order_acquire);
+            if (id == 0) {
+                if (free) *free = i;
+                return 0;
+            }
+            if (eq(values[id - 1])) return id;
+        }
+        return 0;
+    }
+
+    template < typename Eq > uint16_t intern(const T& v, uint64_t hash, Eq eq) {
+        if (const auto id = find(hash, eq, nullptr)) return uint16_t(id);
+
+        const std::lock_guard< std::mutex > lock(mutex);
+        uint32_t                            free = slots;
+        if (const auto id = find(hash, eq, &free)) return uint16_t(id);
+
+        const auto n = count.load(std::memory_order_relaxed);
+        if (n == N || free == slots) return 0;
+        values[n] = v;
+        set_id(&values[n], uint16_t(n + 1));
+        count.store(n + 1, std::memory_order_release);
+        ids[free].store(n + 1, std::memory_order_release);
+        return uint16_t(n + 1);
+    }
+
+    const T* get(uint16_t id) const {
+        if (id == 0 || id > count.load(std::memory_order_acquire)) return nullptr;
+        return &values[id - 1];
+    }
+};
+
+using plmn_table    = intern_table< mcc_mnc_t, intern_plmn_capacity >;
+using s_nssai_table = intern_table< s_nssai_t, intern_s_nssai_capacity >;
+using dnn_table     = intern_table< dnn_t, intern_dnn_capacity >;
+
+plmn_table& plmns() {
+    static plmn_table t;
+    return t;
+}
+s_nssai_table& s_nssais() {
+    static s_nssai_table t;
+    return t;
+}
+dnn_table& dnns() {
+    static dnn_table t;
+    return t;
+}
+
+template < typename T > bool same_opt(const opt_t< T >& a, const opt_t< T >& b) {
+    return a.present == b.present && (!a.present || a.v == b.v);
+}
+bool same_opt(const opt_t< octet_3 >& a, const opt_t< octet_3 >& b) {
+    return a.present == b.present && (!a.present || std::memcmp(a.v, b.v, 3) == 0);
+}
+} // namespace
+
+uint16_t intern_plmn(const mcc_mnc_t& plmn) {
+    const uint8_t key[4] = {uint8_t(plmn.mcc >> 8u), uint8_t(plmn.mcc),
+                            uint8_t(plmn.mnc >> 8u), uint8_t(plmn.mnc)};
+    const auto    hash   = fnv1a(key, sizeof(key));
+    return plmns().intern(plmn, hash, [&plmn](const mcc_mnc_t& v) {
+        return v.mcc == plmn.mcc && v.mnc == plmn.mnc;
+    });
+}
+
+uint16_t intern_s_nssai(const s_nssai_t& nssai) {
+    uint8_t key[10] = {nssai.sst};
+    if (nssai.sd.present) std::memcpy(key + 1, nssai.sd.v, 3);
+    if (nssai.mapped_hplmn_sst.present) key[4] = nssai.mapped_hplmn_sst.v;
+    if (nssai.mapped_hplmn_sd.present) std::memcpy(key + 5, nssai.mapped_hplmn_sd.v, 3);
+    key[8] = uint8_t(nssai.sd.present | nssai.mapped_hplmn_sst.present << 1u |
+                     nssai.mapped_hplmn_sd.present << 2u);
+
+    auto eq = [&nssai](const s_nssai_t& v) {
+        return v.sst == nssai.sst && same_opt(v.sd, nssai.sd) &&
+               same_opt(v.mapped_hplmn_sst, nssai.mapped_hplmn_sst) &&
+               same_opt(v.mapped_hplmn_sd, nssai.mapped_hplmn_sd);
+    };
+    return s_nssais().intern(nssai, fnv1a(key, sizeof(key)), eq);
+}
+
+uint16_t intern_dnn(const uint8_t* dnn, int length) {
+    if (!dnn || length <= 0) return 0;
+    const auto hash = fnv1a(dnn, size_t(length));
+    auto       eq   = [dnn, length](const dnn_t& v) {
+        return v.size() == size_t(length) && std::memcmp(v.data(), dnn, v.size()) == 0;
+    };
+    if (const auto id = dnns().find(hash, eq, nullptr)) return uint16_t(id);
+    return dnns().intern(dnn_t(dnn, dnn + length), hash, eq);
+}
+
+uint16_t intern_dnn(const dnn_t& dnn) {
+    return intern_dnn(dnn.data(), int(dnn.size()));
+}
+
+const mcc_mnc_t* interned_plmn(uint16_t id) {
+    return plmns().get(id);
+}
+
+const s_nssai_t* interned_s_nssai(uint16_t id) {
+    return s_nssais().get(id);
+}
+
+const dnn_t* interned_dnn(uint16_t id) {
+    return dnns().get(id);
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+#include "ies.hh"
+
+/* Process wide interning of the few distinct PLMNs, S-NSSAIs and DNNs a trace carries.
+ * Each value gets a small id, starting at 1, the first time it is seen and keeps it for
+ * the life of the process. Tables only grow, lookups and the accessors below never take
+ * a lock, a new value takes a mutex once. 0 means none: an absent value or a full table.
+ */
+inline extern const uint32_t intern_plmn_capacity    = 1024;
+inline extern const uint32_t intern_s_nssai_capacity = 1024;
+inline extern const uint32_t intern_dnn_capacity     = 4096;
+
+uint16_t intern_plmn(const mcc_mnc_t& plmn);
+uint16_t intern_s_nssai(const s_nssai_t& nssai);
+uint16_t intern_dnn(const uint8_t* dnn, int length); // 9.11.2.1A contents
+uint16_t intern_dnn(const dnn_t& dnn);
+
+// S-NSSAI IE contents as kept by messages that leave it undecoded
+uint16_t intern_s_nssai_octets(const octet_t& contents);
+
+// the interned value, nullptr for an id never handed out
+const mcc_mnc_t* interned_plmn(uint16_t id);
+const s_nssai_t* interned_s_nssai(uint16_t id);
+const dnn_t*     interned_dnn(uint16_t id);
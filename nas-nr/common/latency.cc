@@ -0,0 +1,149 @@
+#include "latency.hh"
+
+#include <cmath>
+
+#include "ue_tracker.hh"
+
+namespace {
+const uint32_t half = 1u << (latency_sub_bits - 1);
+
+// 0 marks a free slot, so the top bit is always set
+uint64_t histogram_key(uint8_t request, uint8_t response, uint32_t plmn, uint8_t cause) {
+    return uint64_t(1) << 63u | uint64_t(plmn & 0xffffffu) << 24u | uint64_t(cause) << 16u |
+           uint64_t(request) << 8u | response;
+}
+
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30u;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27u;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31u);
+}
+
+int msb(uint32_t v) {
+    int n = 0;
+    while (v >>= 1u) ++n;
+    return n;
+}
+} // namespace
+
+uint32_t latency_bucket(uint32_t us) {
+    if (us < 2 * half) return us;
+    const auto shift = uint32_t(msb(us)) - (latency_sub_bits - 1);
+    return shift * half + (us >> shift);
+}
+
+uint32_t latency_bucket_value(uint32_t i) {
+    if (i < 2 * half) return i;
+    const auto shift = i / half - 1;
+    const auto sub   = uint64_t(i - shift * half);
+    return uint32_t(((sub + 1) << shift) - 1);
+}
+
+void latency_histogram::record(uint32_t us) {
+    counts[latency_bucket(us)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(us, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    auto m = max.load(std::memory_order_relaxed);
+    while (us > m && !max.compare_exchange_weak(m, us, std::memory_order_relaxed)) {
+    }
+}
+
+uint32_t latency_snapshot::percentile(double q) const {
+    if (count == 0 || counts.empty()) return 0;
+    if (q <= 0) q = 0;
+    if (q >= 1) return max;
+
+    auto rank = uint64_t(std::ceil(q * double(count)));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            const auto v = latency_bucket_value(i);
+            return v < max ? v : max;
+        }
+    }
+    return max;
+}
+
+double latency_snapshot::mean() const {
+    return count ? double(sum) / double(count) : 0.0;
+}
+
+void latency_snapshot::merge(const latency_snapshot& other) {
+    if (counts.size() < other.counts.size()) counts.resize(other.counts.size());
+    for (size_t i = 0; i < other.counts.size(); ++i) counts[i] += other.counts[i];
+    count += other.count;
+    sum += other.sum;
+    if (other.max > max) max = other.max;
+}
+
+latency_engine::latency_engine(uint32_t capacity) {
+    uint32_t n = 16;
+    while (n < capacity) n <<= 1u;
+    this->capacity = n;
+    slots.reset(new latency_histogram[n]());
+}
+
+bool latency_engine::record(const procedure_event& ev, uint32_t plmn) {
+    const auto key  = histogram_key(ev.request, ev.response, plmn, ev.cause);
+    const auto mask = capacity - 1;
+    auto       i    = uint32_t(mix64(key)) & mask;
+    for (uint32_t probes = 0; probes < capacity; ++probes, i = (i + 1) & mask) {
+        auto& h   = slots[i];
+        auto  cur = h.key.load(std::memory_order_acquire);
+        if (cur == 0) {
+            // claim the slot, or learn who beat us to it
+            if (h.key.compare_exchange_strong(cur, key, std::memory_order_acq_rel))
+                cur = key;
+        }
+        if (cur == key) {
+            h.record(ev.duration_us);
+            return true;
+        }
+    }
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+const latency_histogram* latency_engine::find(uint8_t  request,
+                                              uint8_t  response,
+                                              uint32_t plmn,
+                                              uint8_t  cause) const {
+    const auto key  = histogram_key(request, response, plmn, cause);
+    const auto mask = capacity - 1;
+    auto       i    = uint32_t(mix64(key)) & mask;
+    for (uint32_t probes = 0; probes < capacity; ++probes, i = (i + 1) & mask) {
+        const auto cur = slots[i].key.load(std::memory_order_acquire);
+        if (cur == key) return &slots[i];
+        if (cur == 0) break;
+    }
+    return nullptr;
+}
+
+std::vector< latency_snapshot > latency_engine::snapshot() const {
+    std::vector< latency_snapshot > ret;
+    for (uint32_t i = 0; i < capacity; ++i) {
+        const auto& h   = slots[i];
+        const auto  key = h.key.load(std::memory_order_acquire);
+        if (key == 0) continue;
+
+        latency_snapshot s;
+        s.response = uint8_t(key);
+        s.request  = uint8_t(key >> 8u);
+        s.cause    = uint8_t(key >> 16u);
+        s.plmn     = uint32_t(key >> 24u) & 0xffffffu;
+        s.counts.resize(latency_buckets);
+        // count the buckets rather than read count, so percentiles stay consistent
+        for (uint32_t b = 0; b < latency_buckets; ++b) {
+            s.counts[b] = h.counts[b].load(std::memory_order_relaxed);
+            s.count += s.counts[b];
+        }
+        s.sum = h.sum.load(std::memory_order_relaxed);
+        s.max = h.max.load(std::memory_order_relaxed);
+        ret.push_back(std::move(s));
+    }
+    return ret;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct procedure_event;
+
+/* HDR style log-linear buckets over microseconds: values below 2^latency_sub_bits are
+ * exact, above that each power of two is split into 2^(latency_sub_bits - 1) buckets,
+ * so any recorded value is off by less than 1/64 of itself, up to 2^32 - 1 us. */
+inline extern const uint32_t latency_sub_bits = 7;
+inline extern const uint32_t latency_buckets  = (34 - latency_sub_bits)
+                                                << (latency_sub_bits - 1);
+
+uint32_t latency_bucket(uint32_t us);
+
+// highest value that falls into bucket i
+uint32_t latency_bucket_value(uint32_t i);
+
+// one request/response pair of one PLMN and cause, updated without locks
+struct latency_histogram {
+    std::atomic< uint64_t > key                     = {0}; // 0 while the slot is free
+    std::atomic< uint64_t > count                   = {0};
+    std::atomic< uint64_t > sum                     = {0}; // microseconds
+    std::atomic< uint32_t > max                     = {0};
+    std::atomic< uint64_t > counts[latency_buckets] = {};
+
+    void record(uint32_t us);
+};
+
+// copy of a histogram taken by latency_engine::snapshot(), can be merged across causes or
+// PLMNs
+struct latency_snapshot {
+    uint8_t                 request  = 0; // message types of the pair
+    uint8_t                 response = 0;
+    uint8_t                 cause    = 0;
+    uint32_t                plmn     = 0; // as nas_plmn(), 0 when unknown
+    uint64_t                count    = 0;
+    uint64_t                sum      = 0;
+    uint32_t                max      = 0;
+    std::vector< uint64_t > counts   = {}; // latency_buckets entries
+
+    // value at quantile q in [0, 1], e.g. 0.999 for P99.9
+    uint32_t percentile(double q) const;
+    double   mean() const;
+    void     merge(const latency_snapshot& other);
+};
+
+/* Procedure latencies from ue_tracker events, one histogram per request/response message
+ * pair, PLMN and cause.
+ * Histograms live in a fixed open-addressing table claimed with a compare and swap, so
+ * any number of threads can record into one engine at once. Once the table is full new
+ * combinations are counted in dropped and not recorded. */
+struct latency_engine {
+    explicit latency_engine(uint32_t capacity = 256);
+
+    latency_engine(const latency_engine&) = delete;
+    latency_engine& operator=(const latency_engine&) = delete;
+
+    // records ev->duration_us, false when it had no room
+    bool record(const procedure_event& ev, uint32_t plmn = 0);
+
+    const latency_histogram* find(uint8_t  request,
+                                  uint8_t  response,
+                                  uint32_t plmn  = 0,
+                                  uint8_t  cause = 0) const;
+
+    // histograms recorded so far, a concurrent record() may or may not be included
+    std::vector< latency_snapshot > snapshot() const;
+
+    std::unique_ptr< latency_histogram[] > slots;
+    uint32_t                               capacity = 0;
+    std::atomic< uint64_t >                dropped  = {0};
+};
@@ -0,0 +1,71 @@
+#include "dissects.hh"
+#include "messages.hh"
+
+namespace {
+template < typename element_t, dissect_func_t< element_t > func >
+void decode(const opt_t< lazy_t< element_t, func > >& ie, context* ctx) {
+    (void) lazy_ie(ie, ctx);
+}
+
+void decode_nsm(const nsm_message_t& m, context* ctx) {
+    if (const auto& v = m.pdu_session_establishment_accept) {
+        (void) v->authorized_qos_rules.get(ctx);
+        decode(v->mapped_eps_bearer_contexts, ctx);
+        decode(v->authorized_qos_flow_descs, ctx);
+    }
+    if (const auto& v = m.pdu_session_modification_request) {
+        decode(v->requested_qos_rules, ctx);
+        decode(v->mapped_eps_bearer_contexts, ctx);
+        decode(v->requested_qos_flow_desces, ctx);
+    }
+}
+
+void decode_nmm(const nmm_message_t& m, context* ctx) {
+    if (const auto& v = m.registration_request) {
+        decode(v->nmm_capability, ctx);
+        decode(v->requested_nssai, ctx);
+        decode(v->uplink_data_status, ctx);
+        decode(v->pdu_session_status, ctx);
+    }
+    if (const auto& v = m.registration_accept) {
+        decode(v->tai_list, ctx);
+        decode(v->allowed_nssai, ctx);
+        decode(v->rejected_nssai, ctx);
+        decode(v->configured_nssai, ctx);
+        decode(v->nr_network_feature_support, ctx);
+        decode(v->pdu_session_status, ctx);
+        decode(v->service_area_list, ctx);
+        decode(v->access_categories, ctx);
+    }
+    if (const auto& v = m.service_request) {
+        decode(v->uplink_data_status, ctx);
+        decode(v->pdu_session_status, ctx);
+    }
+    if (const auto& v = m.service_accept) decode(v->pdu_session_status, ctx);
+    if (const auto& v = m.service_reject) decode(v->pdu_session_status, ctx);
+    if (const auto& v = m.notification_response) decode(v->pdu_session_status, ctx);
+    if (const auto& v = m.configuration_update_command) {
+        decode(v->taies, ctx);
+        decode(v->allowed_nssai, ctx);
+        decode(v->service_areas, ctx);
+        decode(v->configured_nssai, ctx);
+        decode(v->rejected_nssai, ctx);
+        decode(v->access_definitions, ctx);
+    }
+    // the 5GSM message a transport carries, decoded in place by de_n1_sm_payload()
+    if (m.ul_nas_transport && m.ul_nas_transport->n1_sm)
+        decode_nsm(*m.ul_nas_transport->n1_sm, ctx);
+    if (m.dl_nas_transport && m.dl_nas_transport->n1_sm)
+        decode_nsm(*m.dl_nas_transport->n1_sm, ctx);
+}
+
+void decode_plain(const nas_message_plain_t& plain, context* ctx) {
+    if (plain.nmm) decode_nmm(*plain.nmm, ctx);
+    if (plain.nsm) decode_nsm(*plain.nsm, ctx);
+}
+} // namespace
+
+void decode_lazy_ies(const nas_message_t& msg, context* ctx) {
+    if (msg.plain) decode_plain(*msg.plain, ctx);
+    if (msg.protect) decode_plain(msg.protect->plain, ctx);
+}
@@ -1,6 +1,7 @@
 #include "definitions.hh"
 #include "dissector.hh"
 #include "ies.hh"
+#include "intern.hh"
 
 result_t die_mcc_mnc(dissector d, context* ctx, mcc_mnc_t* ret) {
     const use_context uc(&d, ctx, "mcc-mnc", 0);
@@ -15,6 +16,7 @@ result_t die_mcc_mnc(dissector d, context* ctx, mcc_mnc_t* ret) {
 
     ret->mnc = 10 * mnc1 + mnc2;
     if (mnc3 != 0xf) ret->mnc = ret->mnc * 10 + mnc3;
+    ret->id = intern_plmn(*ret);
 
     return {uc.consumed()};
 }
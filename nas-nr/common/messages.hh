@@ -133,71 +133,71 @@ XX	Requested extended DRX parameters	9.11.3.60	O	TLV	3
 TBD	T3324 value	GPRS timer 3	9.11.2.5	O	TLV	3
 */
 struct registration_request_t {
-    nmm_header_t      header                            = {};
-    bit_4             nr_registration_type              = {}; // 9.11.3.7 V 1/2
-    bit_4             nksi                              = {}; // 9.11.3.32 V 1/2
-    octet_t           nr_mid                            = {}; // 9.11.3.5 LV-E 6+
-    opt_t< bit_4 >    native_nksi                       = {}; // C- 9.11.3.32 TV 1
-    opt_t< octet_t >  nmm_capability                    = {}; // 10 9.11.3.1 TLV 3+
-    opt_t< octet_t >  security_capability               = {}; // 2E 9.11.3.54 TLV 4+
-    opt_t< octet_t >  requested_nssai                   = {}; // 2F TLV 4+ 9.11.3.37
-    opt_t< octet_6 >  last_visited_tai                  = {}; // 52 TV 7 9.11.3.8
-    opt_t< octet_t >  s1_ue_network_capability          = {}; // 17 TLV 4+ 9.11.3.48
-    opt_t< octet_t >  uplink_data_status                = {}; // 40 TLV 4+ 9.11.3.57
-    opt_t< octet_t >  pdu_session_status                = {}; // 50 TLV 4+ 9.11.3.44
-    opt_t< bit_4 >    mico_ind                          = {}; // B- TV 1 9.11.3.31
-    opt_t< uint8_t >  ue_status                         = {}; // 2B TLV 3 9.11.3.56
-    opt_t< octet_b >  additional_guti_mid               = {}; // 77 TLV-E 14 9.11.3.4
-    opt_t< octet_t >  allowed_pdu_session_status        = {}; // 25 TLV 4+ 9.11.3.13
-    opt_t< uint8_t >  ue_usage_setting                  = {}; // 18 TLV 3 9.11.3.55
-    opt_t< uint8_t >  requested_drx_parameters          = {}; // 51 TLV 3 9.11.3.2A
-    opt_t< octet_t >  eps_nas_container                 = {}; // 70 TLV-E 4+
-    opt_t< octet_t >  ladn_ind                          = {}; // 74 TLV-E 3+
-    opt_t< bit_4 >    payload_container_type            = {}; // 8- TV 1
-    opt_t< octet_t >  payload_container                 = {}; // 7B TLV-E
-    opt_t< bit_4 >    network_slicing_ind               = {}; // 9- TV 1
-    opt_t< uint8_t >  nr_update_type                    = {}; // 53 TLV 3
-    opt_t< octet_3 >  mobile_station_classmark2         = {}; // TBD TLV 5
-    opt_t< octet_t >  supported_codecs                  = {}; // TBD TLV 5+
-    opt_t< octet_t >  nas_message_container             = {}; // 71 TLV-E 4+
-    opt_t< uint16_t > eps_bearer_context_status         = {}; // 60 TLV 4
-    opt_t< uint8_t >  requested_extended_drx_parameters = {}; // XX TLV 3
-    opt_t< uint8_t >  t3324                             = {}; // TBD TLV 3
+    nmm_header_t                       header                            = {};
+    bit_4                              nr_registration_type              = {}; // 9.11.3.7 V 1/2
+    bit_4                              nksi                              = {}; // 9.11.3.32 V 1/2
+    octet_t                            nr_mid                            = {}; // 9.11.3.5 LV-E 6+
+    opt_t< bit_4 >                     native_nksi                       = {}; // C- 9.11.3.32 TV 1
+    opt_t< lazy_nmm_capability_t >     nmm_capability                    = {}; // 10 9.11.3.1 TLV 3+
+    opt_t< octet_t >                   security_capability               = {}; // 2E 9.11.3.54 TLV 4+
+    opt_t< lazy_nssai_t >              requested_nssai                   = {}; // 2F TLV 4+ 9.11.3.37
+    opt_t< octet_6 >                   last_visited_tai                  = {}; // 52 TV 7 9.11.3.8
+    opt_t< octet_t >                   s1_ue_network_capability          = {}; // 17 TLV 4+ 9.11.3.48
+    opt_t< lazy_uplink_data_status_t > uplink_data_status                = {}; // 40 TLV 4+ 9.11.3.57
+    opt_t< lazy_pdu_session_status_t > pdu_session_status                = {}; // 50 TLV 4+ 9.11.3.44
+    opt_t< bit_4 >                     mico_ind                          = {}; // B- TV 1 9.11.3.31
+    opt_t< uint8_t >                   ue_status                         = {}; // 2B TLV 3 9.11.3.56
+    opt_t< octet_b >                   additional_guti_mid               = {}; // 77 TLV-E 14 9.11.3.4
+    opt_t< octet_t >                   allowed_pdu_session_status        = {}; // 25 TLV 4+ 9.11.3.13
+    opt_t< uint8_t >                   ue_usage_setting                  = {}; // 18 TLV 3 9.11.3.55
+    opt_t< uint8_t >                   requested_drx_parameters          = {}; // 51 TLV 3 9.11.3.2A
+    opt_t< octet_t >                   eps_nas_container                 = {}; // 70 TLV-E 4+
+    opt_t< octet_t >                   ladn_ind                          = {}; // 74 TLV-E 3+
+    opt_t< bit_4 >                     payload_container_type            = {}; // 8- TV 1
+    opt_t< octet_t >                   payload_container                 = {}; // 7B TLV-E
+    opt_t< bit_4 >                     network_slicing_ind               = {}; // 9- TV 1
+    opt_t< uint8_t >                   nr_update_type                    = {}; // 53 TLV 3
+    opt_t< octet_3 >                   mobile_station_classmark2         = {}; // TBD TLV 5
+    opt_t< octet_t >                   supported_codecs                  = {}; // TBD TLV 5+
+    opt_t< octet_t >                   nas_message_container             = {}; // 71 TLV-E 4+
+    opt_t< uint16_t >                  eps_bearer_context_status         = {}; // 60 TLV 4
+    opt_t< uint8_t >                   requested_extended_drx_parameters = {}; // XX TLV 3
+    opt_t< uint8_t >                   t3324                             = {}; // TBD TLV 3
 };
 
 struct registration_accept_t {
-    nmm_header_t      header                                      = {};
-    uint8_t           nr_registration_result                      = {}; // LV 2
-    opt_t< octet_b >  guti_nr_mid                                 = {}; // 77 TLV-E 14
-    opt_t< octet_t >  equivalent_plmns                            = {}; // 4A TLV 5+
-    opt_t< octet_t >  tai_list                                    = {}; // 54 TLV 9+
-    opt_t< octet_t >  allowed_nssai                               = {}; // 15 TLV 4+
-    opt_t< octet_t >  rejected_nssai                              = {}; // 11 TLV 4+
-    opt_t< octet_t >  configured_nssai                            = {}; // 31 TLV 4+
-    opt_t< octet_t >  nr_network_feature_support                  = {}; // 21 TLV 3+
-    opt_t< octet_t >  pdu_session_status                          = {}; // 50 TLV 4+
-    opt_t< octet_t >  pdu_session_reactivation_result             = {}; // 26 TLV 4+
-    opt_t< octet_t >  pdu_session_reactivation_result_error_cause = {}; // 72 TLV-E 5+
-    opt_t< octet_t >  ladn_information                            = {}; // 79 TLV-E 12+
-    opt_t< bit_4 >    mico_ind                                    = {}; // B- TV 1
-    opt_t< bit_4 >    network_slicing_ind                         = {}; // 9- TV 1
-    opt_t< octet_t >  service_area_list                           = {}; // 27 TLV 6+
-    opt_t< uint8_t >  t3512                                       = {}; // 5E TLV 3
-    opt_t< uint8_t >  n3_deregistration_timer                     = {}; // 5D TLV 3
-    opt_t< uint8_t >  t3502                                       = {}; // 16 TLV 3
-    opt_t< octet_t >  emergency_numbers                           = {}; // 34 TLV 5+
-    opt_t< octet_t >  extended_emergency_numbers                  = {}; // 7A TLV-E 7+
-    opt_t< octet_t >  sor_container                               = {}; // 73 TLV-E 20+
-    opt_t< octet_t >  eap                                         = {}; // 78 TLV-E 7+
-    opt_t< bit_4 >    nssai_inclusion_mode                        = {}; // A- TV 1
-    opt_t< octet_t >  access_categories                           = {}; // 76 TLV-E
-    opt_t< uint8_t >  negotiated_drx_parameters                   = {}; // 51 TLV 3
-    opt_t< bit_4 >    n3_nw_provided_policies                     = {}; // D- TV 1
-    opt_t< uint16_t > eps_bearer_context_status                   = {}; // 60 TLV 4
-    opt_t< uint8_t >  negotiated_extended_drx_parameters          = {}; // XX TLV 3
-    opt_t< uint8_t >  t3447                                       = {}; // TBD TVL 3
-    opt_t< uint8_t >  t3348                                       = {}; // XX TLV 3
-    opt_t< uint8_t >  t3324                                       = {}; // TBD TLV 3
+    nmm_header_t                               header                                      = {};
+    uint8_t                                    nr_registration_result                      = {}; // LV 2
+    opt_t< octet_b >                           guti_nr_mid                                 = {}; // 77 TLV-E 14
+    opt_t< octet_t >                           equivalent_plmns                            = {}; // 4A TLV 5+
+    opt_t< lazy_tai_list_t >                   tai_list                                    = {}; // 54 TLV 9+
+    opt_t< lazy_nssai_t >                      allowed_nssai                               = {}; // 15 TLV 4+
+    opt_t< lazy_rejected_nssai_t >             rejected_nssai                              = {}; // 11 TLV 4+
+    opt_t< lazy_nssai_t >                      configured_nssai                            = {}; // 31 TLV 4+
+    opt_t< lazy_nr_network_feature_support_t > nr_network_feature_support                  = {}; // 21 TLV 3+
+    opt_t< lazy_pdu_session_status_t >         pdu_session_status                          = {}; // 50 TLV 4+
+    opt_t< octet_t >                           pdu_session_reactivation_result             = {}; // 26 TLV 4+
+    opt_t< octet_t >                           pdu_session_reactivation_result_error_cause = {}; // 72 TLV-E 5+
+    opt_t< octet_t >                           ladn_information                            = {}; // 79 TLV-E 12+
+    opt_t< bit_4 >                             mico_ind                                    = {}; // B- TV 1
+    opt_t< bit_4 >                             network_slicing_ind                         = {}; // 9- TV 1
+    opt_t< lazy_service_area_list_t >          service_area_list                           = {}; // 27 TLV 6+
+    opt_t< uint8_t >                           t3512                                       = {}; // 5E TLV 3
+    opt_t< uint8_t >                           n3_deregistration_timer                     = {}; // 5D TLV 3
+    opt_t< uint8_t >                           t3502                                       = {}; // 16 TLV 3
+    opt_t< octet_t >                           emergency_numbers                           = {}; // 34 TLV 5+
+    opt_t< octet_t >                           extended_emergency_numbers                  = {}; // 7A TLV-E 7+
+    opt_t< octet_t >                           sor_container                               = {}; // 73 TLV-E 20+
+    opt_t< octet_t >                           eap                                         = {}; // 78 TLV-E 7+
+    opt_t< bit_4 >                             nssai_inclusion_mode                        = {}; // A- TV 1
+    opt_t< lazy_access_category_definitions_t > access_categories                          = {}; // 76 TLV-E
+    opt_t< uint8_t >                           negotiated_drx_parameters                   = {}; // 51 TLV 3
+    opt_t< bit_4 >                             n3_nw_provided_policies                     = {}; // D- TV 1
+    opt_t< uint16_t >                          eps_bearer_context_status                   = {}; // 60 TLV 4
+    opt_t< uint8_t >                           negotiated_extended_drx_parameters          = {}; // XX TLV 3
+    opt_t< uint8_t >                           t3447                                       = {}; // TBD TVL 3
+    opt_t< uint8_t >                           t3348                                       = {}; // XX TLV 3
+    opt_t< uint8_t >                           t3324                                       = {}; // TBD TLV 3
 };
 
 /*
@@ -263,6 +263,10 @@ struct ul_nas_transport_t {
     opt_t< octet_t > dnn                        = {}; // 25 TLV 3+
     opt_t< octet_t > additional_information     = {}; // 24 TLV 3+
     opt_t< bit_4 >   ma_pdu_session_information = {}; // Z TV 1
+    uint16_t         s_nssai_id                 = {}; // intern_s_nssai_octets()
+    uint16_t         dnn_id                     = {}; // intern_dnn()
+
+    std::shared_ptr< nsm_message_t > n1_sm = {}; // payload, see de_n1_sm_payload()
 };
 
 /*
@@ -288,6 +292,8 @@ struct dl_nas_transport_t {
     opt_t< octet_t > additional_information = {}; // 24 TLV 3+
     opt_t< uint8_t > nmm_cause                  = {}; // 58 TV 2
     opt_t< uint8_t > backoff_timer          = {}; // 37 TLV 3
+
+    std::shared_ptr< nsm_message_t > n1_sm = {}; // payload, see de_n1_sm_payload()
 };
 
 /*
@@ -369,14 +375,14 @@ IEI	Information Element	Type/Reference	Presence	Format	Length
 struct nas_message_t;
 
 struct service_request_t {
-    nmm_header_t     header                     = {};
-    bit_4            nksi                       = {}; // 9.11.3.32 1/2
-    bit_4            type                       = {}; // 9.11.3.50 1/2
-    octet_7          tmsi_nmid                  = {}; // 9.11.3.4 LV-E 9
-    opt_t< octet_t > uplink_data_status         = {}; // 40 TLV 4+
-    opt_t< octet_t > pdu_session_status         = {}; // 50 TLV 4+
-    opt_t< octet_t > allowed_pdu_session_status = {}; // 25 TLV 4+
-    opt_t< octet_t > message                    = {}; // 71 TLV-E 4+
+    nmm_header_t                       header                     = {};
+    bit_4                              nksi                       = {}; // 9.11.3.32 1/2
+    bit_4                              type                       = {}; // 9.11.3.50 1/2
+    octet_7                            tmsi_nmid                  = {}; // 9.11.3.4 LV-E 9
+    opt_t< lazy_uplink_data_status_t > uplink_data_status         = {}; // 40 TLV 4+
+    opt_t< lazy_pdu_session_status_t > pdu_session_status         = {}; // 50 TLV 4+
+    opt_t< octet_t >                   allowed_pdu_session_status = {}; // 25 TLV 4+
+    opt_t< octet_t >                   message                    = {}; // 71 TLV-E 4+
 };
 
 /*
@@ -393,12 +399,12 @@ IEI	Information Element	Type/Reference	Presence	Format	Length
 XX	T3448 value	GPRS timer 3	9.11.2.4	O	TLV	3
 */
 struct service_accept_t {
-    nmm_header_t     header                          = {};
-    opt_t< octet_t > pdu_session_status              = {}; // 50 TLV 4+
-    opt_t< octet_t > pdu_session_reactivation_result = {}; // 26 TLV 4+
-    opt_t< octet_t > result_error_cause              = {}; // 72 TLV-E 5+
-    opt_t< eap_t >   eap                             = {}; // 78 TLV-E 7+
-    opt_t< uint8_t > t3348                           = {}; // XX TLV 3
+    nmm_header_t                       header                          = {};
+    opt_t< lazy_pdu_session_status_t > pdu_session_status              = {}; // 50 TLV 4+
+    opt_t< octet_t >                   pdu_session_reactivation_result = {}; // 26 TLV 4+
+    opt_t< octet_t >                   result_error_cause              = {}; // 72 TLV-E 5+
+    opt_t< eap_t >                     eap                             = {}; // 78 TLV-E 7+
+    opt_t< uint8_t >                   t3348                           = {}; // XX TLV 3
 };
 
 /*
@@ -415,12 +421,12 @@ IEI	Information Element	Type/Reference	Presence	Format	Length
 XX	T3448 value	GPRS timer 3	9.11.2.4	O	TLV	3
 */
 struct service_reject_t {
-    nmm_header_t     header             = {};
-    uint8_t          nmm_cause              = {}; // 9.11.3.2
-    opt_t< octet_t > pdu_session_status = {}; // 50 TLV 4+
-    opt_t< uint8_t > t3346              = {}; // 5F TLV 3
-    opt_t< eap_t >   eap                = {}; // 78 TLV-E 7+
-    opt_t< uint8_t > t3348              = {}; // XX TLV 3
+    nmm_header_t                       header             = {};
+    uint8_t                            nmm_cause          = {}; // 9.11.3.2
+    opt_t< lazy_pdu_session_status_t > pdu_session_status = {}; // 50 TLV 4+
+    opt_t< uint8_t >                   t3346              = {}; // 5F TLV 3
+    opt_t< eap_t >                     eap                = {}; // 78 TLV-E 7+
+    opt_t< uint8_t >                   t3348              = {}; // XX TLV 3
 };
 
 /*
@@ -450,25 +456,25 @@ F-	SMS indication	SMS indication	9.11.3.50A O TV	1
 Tbd	T3447 value	GPRS timer 3	9.11.2.5	O	TLV	3
 */
 struct configuration_update_command_t {
-    nmm_header_t     header               = {};
-    opt_t< uint8_t > ind                  = {}; // D- TV 1
-    opt_t< octet_b > nguti_nmid           = {}; // 77 TLVE 14
-    opt_t< octet_t > taies                = {}; // 54 TLV 9+
-    opt_t< octet_t > allowed_nssai        = {}; // 15 TLV 4+
-    opt_t< octet_t > service_areas        = {}; // 27 TLV 6+
-    opt_t< octet_t > full_name            = {}; // 43 TLV 3+
-    opt_t< octet_t > short_name           = {}; // 45 TLV 3+
-    opt_t< uint8_t > local_time_zone      = {}; // 46 TV 2
-    opt_t< octet_7 > utc                  = {}; // 47 TV 8
-    opt_t< uint8_t > daylight_saving_time = {}; // 49 TLV 3
-    opt_t< octet_t > ladn_information     = {}; // 79 TLVE 3+
-    opt_t< bit_4 >   mico_ind             = {}; // B- TV 1
-    opt_t< bit_4 >   network_slicing_ind  = {}; // 9- TV 1
-    opt_t< octet_t > configured_nssai     = {}; // 31 TLV 4+
-    opt_t< octet_t > rejected_nssai       = {}; // 11 TLV 4+
-    opt_t< octet_t > access_definitions   = {}; // 76 TLVE 3+
-    opt_t< bit_4 >   sms_ind              = {}; // F- TV 1
-    opt_t< uint8_t > t3347                = {}; // TBD TLV 3
+    nmm_header_t                      header               = {};
+    opt_t< uint8_t >                  ind                  = {}; // D- TV 1
+    opt_t< octet_b >                  nguti_nmid           = {}; // 77 TLVE 14
+    opt_t< lazy_tai_list_t >          taies                = {}; // 54 TLV 9+
+    opt_t< lazy_nssai_t >             allowed_nssai        = {}; // 15 TLV 4+
+    opt_t< lazy_service_area_list_t > service_areas        = {}; // 27 TLV 6+
+    opt_t< octet_t >                  full_name            = {}; // 43 TLV 3+
+    opt_t< octet_t >                  short_name           = {}; // 45 TLV 3+
+    opt_t< uint8_t >                  local_time_zone      = {}; // 46 TV 2
+    opt_t< octet_7 >                  utc                  = {}; // 47 TV 8
+    opt_t< uint8_t >                  daylight_saving_time = {}; // 49 TLV 3
+    opt_t< octet_t >                  ladn_information     = {}; // 79 TLVE 3+
+    opt_t< bit_4 >                    mico_ind             = {}; // B- TV 1
+    opt_t< bit_4 >                    network_slicing_ind  = {}; // 9- TV 1
+    opt_t< lazy_nssai_t >             configured_nssai     = {}; // 31 TLV 4+
+    opt_t< lazy_rejected_nssai_t >    rejected_nssai       = {}; // 11 TLV 4+
+    opt_t< lazy_access_category_definitions_t > access_definitions = {}; // 76 TLVE 3+
+    opt_t< bit_4 >                    sms_ind              = {}; // F- TV 1
+    opt_t< uint8_t >                  t3347                = {}; // TBD TLV 3
 };
 
 /*
@@ -538,8 +544,8 @@ IEI	Information Element	Type/Reference	Presence	Format	Length
 50	PDU session status	PDU session status	9.11.3.44	O	TLV	4-34
 */
 struct notification_response_t {
-    nmm_header_t     header             = {};
-    opt_t< octet_t > pdu_session_status = {}; // 50
+    nmm_header_t                       header             = {};
+    opt_t< lazy_pdu_session_status_t > pdu_session_status = {}; // 50
 };
 
 /*
@@ -687,26 +693,28 @@ XX	Control plane only indication	9.11.4.23	O	TV	1
 */
 // clang-format on
 struct pdu_session_establishment_accept_t {
-    nsm_header_t                           header                    = {};
-    bit_4                                  selected_pdu_session_type = {}; // 9.11.4.11 V
-    bit_4                                  selected_ssc_mode    = {}; // 9.11.4.16 V 1/2
-    octet_t                                authorized_qos_rules = {}; // 9.11.4.13 LV-E 6+
-    octet_6                                session_ambr         = {}; // 9.11.4.14 LV 7
-    opt_t< uint8_t >                       nsm_cause                = {}; // 59 TV 2
-    opt_t< octet_t >                       pdu_address          = {}; // 29 TLV 7+
-    opt_t< uint8_t >                       rq_timer             = {}; // 56 TV 2
-    opt_t< octet_t >                       s_nssai              = {}; // 22 TLV 3+
-    opt_t< bit_4 >                         always_on_pdu_session_ind   = {}; // 8- TV 1
-    opt_t< octet_t >                       mapped_eps_bearer_contexts  = {}; // 75
-    opt_t< eap_t >                         eap                         = {}; // 78 TLVE
-    opt_t< octet_t >                       authorized_qos_flow_descs   = {}; // 79 TLVE
-    opt_t< octet_t >                       extended_pco                = {}; // 7B TLVE
-    opt_t< dnn_t >                         dnn                         = {}; // 25 TLV
-    opt_t< nsm_network_feature_support_t > nsm_network_feature_support = {}; // XX TLV
-    opt_t< session_tmbr_t >                session_tmbr              = {}; // XX TLV
-    opt_t< uint16_t >                      serving_plmn_rate_control   = {}; // TBD TLV
-    opt_t< atsss_container_t >             atsss_container             = {}; // XX TLVE
-    opt_t< bit_4 >                         control_plane_only_ind     = {}; // XX TV 1
+    nsm_header_t                               header                      = {};
+    bit_4                                      selected_pdu_session_type   = {}; // 9.11.4.11 V
+    bit_4                                      selected_ssc_mode           = {}; // 9.11.4.16 V 1/2
+    lazy_qos_rules_t                           authorized_qos_rules        = {}; // 9.11.4.13 LV-E 6+
+    octet_6                                    session_ambr                = {}; // 9.11.4.14 LV 7
+    opt_t< uint8_t >                           nsm_cause                   = {}; // 59 TV 2
+    opt_t< octet_t >                           pdu_address                 = {}; // 29 TLV 7+
+    opt_t< uint8_t >                           rq_timer                    = {}; // 56 TV 2
+    opt_t< octet_t >                           s_nssai                     = {}; // 22 TLV 3+
+    opt_t< bit_4 >                             always_on_pdu_session_ind   = {}; // 8- TV 1
+    opt_t< lazy_mapped_eps_bearer_contexts_t > mapped_eps_bearer_contexts  = {}; // 75
+    opt_t< eap_t >                             eap                         = {}; // 78 TLVE
+    opt_t< lazy_qos_flow_descriptions_t >      authorized_qos_flow_descs   = {}; // 79 TLVE
+    opt_t< octet_t >                           extended_pco                = {}; // 7B TLVE
+    opt_t< dnn_t >                             dnn                         = {}; // 25 TLV
+    opt_t< nsm_network_feature_support_t >     nsm_network_feature_support = {}; // XX TLV
+    opt_t< session_tmbr_t >                    session_tmbr                = {}; // XX TLV
+    opt_t< uint16_t >                          serving_plmn_rate_control   = {}; // TBD TLV
+    opt_t< atsss_container_t >                 atsss_container             = {}; // XX TLVE
+    opt_t< bit_4 >                             control_plane_only_ind      = {}; // XX TV 1
+    uint16_t                                   s_nssai_id                  = {}; // interned
+    uint16_t                                   dnn_id                      = {}; // interned
 };
 
 // clang-format off
@@ -809,16 +817,16 @@ B-	Always-on PDU session requested	9.11.4.4	O	TV	1
 */
 // clang-format on
 struct pdu_session_modification_request_t {
-    nsm_header_t      header                          = {};
-    opt_t< octet_t >  nsm_capabilities                    = {}; // 28 TLV 3+
-    opt_t< uint8_t >  nsm_cause                           = {}; // 59 TV 2
-    opt_t< uint16_t > supported_packet_filters_max_n  = {}; // 55 TV 3
-    opt_t< bit_4 >    always_on_pdu_session_requested = {}; // B- TV 1
-    opt_t< uint16_t > integrity_max_data_rate         = {}; // 13 TV 3
-    opt_t< octet_t >  requested_qos_rules             = {}; // 7A TLVE
-    opt_t< octet_t >  requested_qos_flow_desces        = {}; // 79 TLVE
-    opt_t< octet_t >  mapped_eps_bearer_contexts      = {}; // 75 TLVE
-    opt_t< octet_t >  extended_pco                    = {}; // 7B TLVE
+    nsm_header_t                               header                          = {};
+    opt_t< octet_t >                           nsm_capabilities                = {}; // 28 TLV 3+
+    opt_t< uint8_t >                           nsm_cause                       = {}; // 59 TV 2
+    opt_t< uint16_t >                          supported_packet_filters_max_n  = {}; // 55 TV 3
+    opt_t< bit_4 >                             always_on_pdu_session_requested = {}; // B- TV 1
+    opt_t< uint16_t >                          integrity_max_data_rate         = {}; // 13 TV 3
+    opt_t< lazy_qos_rules_t >                  requested_qos_rules             = {}; // 7A TLVE
+    opt_t< lazy_qos_flow_descriptions_t >      requested_qos_flow_desces       = {}; // 79 TLVE
+    opt_t< lazy_mapped_eps_bearer_contexts_t > mapped_eps_bearer_contexts      = {}; // 75 TLVE
+    opt_t< octet_t >                           extended_pco                    = {}; // 7B TLVE
 };
 
 // clang-format off
@@ -0,0 +1,88 @@
+#include "nas_count.hh"
+
+#include "context.hh"
+#include "packet.hh"
+
+namespace {
+struct count_ref {
+    uint32_t* overflow = nullptr;
+    uint32_t* seq_no   = nullptr;
+    bool*     seen     = nullptr;
+};
+
+count_ref count_of(nr_security_context* ctx, int dir) {
+    if (dir == direction::ul)
+        return {&ctx->ul_count_overflow, &ctx->ul_count_seq_no, &ctx->ul_count_seen};
+    if (dir == direction::dl)
+        return {&ctx->dl_count_overflow, &ctx->dl_count_seq_no, &ctx->dl_count_seen};
+    return {};
+}
+
+// how far ahead of the highest COUNT seen an unchecked COUNT may move it
+const uint32_t nas_count_forward_window = 256 - nas_count_reorder_window;
+
+// overflow value whose COUNT is nearest to the highest one seen, biased forward: a
+// sequence number within the reorder window behind the last one stays in the same cycle,
+// one that would be almost a full cycle ahead is a late one from the cycle before
+uint32_t nearest_overflow(uint32_t overflow, uint32_t last_seq, uint32_t seq_no) {
+    if (seq_no >= last_seq) {
+        if (seq_no - last_seq > nas_count_forward_window && overflow > 0)
+            return overflow - 1;
+        return overflow;
+    }
+    if (last_seq - seq_no <= nas_count_reorder_window) return overflow;
+    return (overflow + 1) & 0xffffu;
+}
+} // namespace
+
+bool estimate_nas_count(nr_security_context*   ctx,
+                        int                    dir,
+                        uint8_t                seq_no,
+                        uint32_t*              count,
+                        const nas_count_check& check) {
+    if (!ctx || !count) return false;
+    const auto ref = count_of(ctx, dir);
+    if (!ref.overflow) return false;
+
+    // the first COUNT seen is taken in the stored overflow cycle, there is nothing yet to
+    // be near to
+    const auto seen     = *ref.seen;
+    const auto last     = nas_count(*ref.overflow, *ref.seq_no);
+    const auto estimate =
+        seen ? nearest_overflow(*ref.overflow, *ref.seq_no, seq_no) : *ref.overflow;
+
+    auto candidate = nas_count(estimate, seq_no);
+    auto found     = !check || check(candidate);
+
+    // walk outwards from the estimate: +1, -1, +2, -2 ...
+    for (uint32_t i = 1; !found && i <= nas_count_max_overflow_probe; ++i) {
+        candidate = nas_count(estimate + i, seq_no);
+        if (estimate + i <= 0xffffu && check(candidate)) {
+            found = true;
+            break;
+        }
+        candidate = nas_count(estimate - i, seq_no);
+        if (estimate >= i && check(candidate)) found = true;
+    }
+    if (!found) return false;
+
+    *count = candidate;
+    // without a MAC check nothing confirms a jump of almost a cycle, keep ctx where it is
+    if (seen && !check && candidate > last + nas_count_forward_window) return true;
+    if (!seen || candidate > last) {
+        *ref.overflow = candidate >> 8u;
+        *ref.seq_no   = candidate & 0xffu;
+        *ref.seen     = true;
+    }
+    return true;
+}
+
+void reset_nas_count(nr_security_context* ctx) {
+    if (!ctx) return;
+    ctx->ul_count_overflow = 0;
+    ctx->ul_count_seq_no   = 0;
+    ctx->dl_count_overflow = 0;
+    ctx->dl_count_seq_no   = 0;
+    ctx->ul_count_seen     = false;
+    ctx->dl_count_seen     = false;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+struct nr_security_context;
+
+// TS 33.501 6.4.3.1: NAS COUNT = 0x00 || NAS OVERFLOW (16 bits) || NAS SQN (8 bits)
+inline uint32_t nas_count(uint32_t overflow, uint32_t seq_no) {
+    return (overflow & 0xffffu) << 8u | (seq_no & 0xffu);
+}
+
+// how far behind the highest COUNT seen a sequence number is still taken as reordered or
+// retransmitted instead of as the start of the next overflow cycle
+inline extern const uint32_t nas_count_reorder_window = 64;
+
+// how many overflow values either side of the estimate are tried once the MAC rejects it,
+// 16 overflow values cover 4096 messages lost from the capture
+inline extern const uint32_t nas_count_max_overflow_probe = 16;
+
+// returns true when the message MAC verifies under the candidate COUNT
+using nas_count_check = std::function< bool(uint32_t count) >;
+
+/* Rebuild the full COUNT of a protected message from its 8 bits sequence number.
+ * dir is direction::ul or direction::dl and selects the ul_count_* or dl_count_* pair of
+ * ctx, which holds the highest COUNT accepted so far in that direction; the first one
+ * accepted after a reset is the baseline whatever its sequence number.
+ * The estimate is the candidate nearest to that COUNT, accounting for capture loss,
+ * reordering and retransmission. When check is given and rejects it, the neighbouring
+ * overflow values are tried nearest first. On success *count gets the COUNT and ctx moves
+ * forward if it is newer, by less than a cycle less the reorder window when unchecked; on
+ * failure ctx is left untouched and false is returned. */
+bool estimate_nas_count(nr_security_context*   ctx,
+                        int                    dir,
+                        uint8_t                seq_no,
+                        uint32_t*              count,
+                        const nas_count_check& check = nullptr);
+
+// a new NAS security context starts both COUNTs from zero, TS 33.501 6.4.3.1, with no
+// COUNT seen yet
+void reset_nas_count(nr_security_context* ctx);
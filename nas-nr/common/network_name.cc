@@ -0,0 +1,211 @@
+#include "network_name.hh"
+
+#include <cstring>
+
+namespace {
+// TS 23.038 6.2.1 GSM 7 bit default alphabet
+const uint16_t gsm7_default[128] = {
+    0x0040, 0x00a3, 0x0024, 0x00a5, 0x00e8, 0x00e9, 0x00f9, 0x00ec, // @ £ $ ¥ è é ù ì
+    0x00f2, 0x00c7, 0x000a, 0x00d8, 0x00f8, 0x000d, 0x00c5, 0x00e5, // ò Ç LF Ø ø CR Å å
+    0x0394, 0x005f, 0x03a6, 0x0393, 0x039b, 0x03a9, 0x03a0, 0x03a8, // Δ _ Φ Γ Λ Ω Π Ψ
+    0x03a3, 0x0398, 0x039e, 0x00a0, 0x00c6, 0x00e6, 0x00df, 0x00c9, // Σ Θ Ξ ESC Æ æ ß É
+    0x0020, 0x0021, 0x0022, 0x0023, 0x00a4, 0x0025, 0x0026, 0x0027, //   ! " # ¤ % & '
+    0x0028, 0x0029, 0x002a, 0x002b, 0x002c, 0x002d, 0x002e, 0x002f, //
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037, //
+    0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x003d, 0x003e, 0x003f, //
+    0x00a1, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047, // ¡ A ...
+    0x0048, 0x0049, 0x004a, 0x004b, 0x004c, 0x004d, 0x004e, 0x004f, //
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057, //
+    0x0058, 0x0059, 0x005a, 0x00c4, 0x00d6, 0x00d1, 0x00dc, 0x00a7, // ... Z Ä Ö Ñ Ü §
+    0x00bf, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067, // ¿ a ...
+    0x0068, 0x0069, 0x006a, 0x006b, 0x006c, 0x006d, 0x006e, 0x006f, //
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077, //
+    0x0078, 0x0079, 0x007a, 0x00e4, 0x00f6, 0x00f1, 0x00fc, 0x00e0, // ... z ä ö ñ ü à
+};
+
+const uint8_t gsm7_escape = 0x1b;
+
+// TS 23.038 6.2.1.1 extension table, 0 where the default alphabet applies
+uint16_t gsm7_extension(uint8_t c) {
+    switch (c) {
+    case 0x0a: return 0x000c; // form feed
+    case 0x14: return 0x005e; // ^
+    case 0x28: return 0x007b; // {
+    case 0x29: return 0x007d; // }
+    case 0x2f: return 0x005c; // backslash
+    case 0x3c: return 0x005b; // [
+    case 0x3d: return 0x007e; // ~
+    case 0x3e: return 0x005d; // ]
+    case 0x40: return 0x007c; // |
+    case 0x65: return 0x20ac; // €
+    default: return 0;
+    }
+}
+
+// appends one code point, false when it does not fit
+bool put_utf8(uint32_t c, char* out, int capacity, int* n) {
+    auto* p = reinterpret_cast< uint8_t* >(out) + *n;
+    if (c < 0x80) {
+        if (*n + 1 > capacity) return false;
+        p[0] = uint8_t(c);
+        *n += 1;
+    } else if (c < 0x800) {
+        if (*n + 2 > capacity) return false;
+        p[0] = uint8_t(0xc0u | c >> 6u);
+        p[1] = uint8_t(0x80u | (c & 0x3fu));
+        *n += 2;
+    } else {
+        if (*n + 3 > capacity) return false;
+        p[0] = uint8_t(0xe0u | c >> 12u);
+        p[1] = uint8_t(0x80u | (c >> 6u & 0x3fu));
+        p[2] = uint8_t(0x80u | (c & 0x3fu));
+        *n += 3;
+    }
+    return true;
+}
+
+// eight septets from seven little endian octets, one per octet of the result
+uint64_t spread_septets(uint64_t v) {
+    v = (v & 0x000000000fffffffULL) | (v & 0x00fffffff0000000ULL) << 4u;
+    v = (v & 0x00003fff00003fffULL) | (v & 0x0fffc0000fffc000ULL) << 2u;
+    v = (v & 0x007f007f007f007fULL) | (v & 0x3f803f803f803f80ULL) << 1u;
+    return v;
+}
+
+uint64_t load_le(const uint8_t* p, int n) {
+    uint64_t v = 0;
+    for (auto i = n - 1; i >= 0; --i) v = v << 8u | p[i];
+    return v;
+}
+
+// host order from or to little endian
+uint64_t le64(uint64_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap64(v);
+#else
+    return v;
+#endif
+}
+
+int text_to_utf8(uint8_t        coding_scheme,
+                 uint8_t        spare_bits,
+                 const uint8_t* text,
+                 int            length,
+                 char*          out,
+                 int            capacity) {
+    int n = -1;
+    if (coding_scheme == network_name_coding::gsm7) {
+        // at most 8 septets per 7 octets, unpacked on the stack
+        uint8_t septets[256 * 8 / 7 + 8];
+        if (length > 256) return -1;
+        const auto count =
+            gsm7_unpack(text, length, spare_bits, septets, int(sizeof(septets)));
+        n = count < 0 ? -1 : gsm7_to_utf8(septets, count, out, capacity);
+        // 23.038 6.1.2.3.1 a CR filling the last septet of a full octet is padding
+        if (n > 0 && spare_bits == 0 && count % 8 == 0 && out[n - 1] == '\r') --n;
+    } else if (coding_scheme == network_name_coding::ucs2) {
+        n = ucs2_to_utf8(text, length, out, capacity);
+    }
+    if (n >= 0 && n < capacity) out[n] = '\0';
+    return n;
+}
+
+uint64_t name_key(uint32_t plmn, bool short_name) {
+    return uint64_t(plmn) << 1u | (short_name ? 1u : 0u);
+}
+} // namespace
+
+int gsm7_unpack(const uint8_t* packed,
+                int            length,
+                int            spare_bits,
+                uint8_t*       out,
+                int            capacity) {
+    if (!packed || length <= 0) return 0;
+    const int count = (length * 8 - (spare_bits & 0x07)) / 7;
+    if (count > capacity) return -1;
+
+    int i = 0, o = 0;
+    // whole groups while eight octets can be read and written at once
+    for (; i + 8 <= length && o + 8 <= capacity; i += 7, o += 8) {
+        uint64_t v;
+        std::memcpy(&v, packed + i, 8);
+        v = le64(spread_septets(le64(v) & 0x00ffffffffffffffULL));
+        std::memcpy(out + o, &v, 8);
+    }
+    // the rest a group at a time, the last one partial
+    for (; i < length; i += 7, o += 8) {
+        const int in = length - i < 7 ? length - i : 7;
+        const int n  = count - o < 8 ? count - o : 8;
+        auto      v  = spread_septets(load_le(packed + i, in));
+        for (auto k = 0; k < n; ++k, v >>= 8u) out[o + k] = uint8_t(v);
+    }
+    return count;
+}
+
+int gsm7_to_utf8(const uint8_t* septets, int count, char* out, int capacity) {
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+        const auto c = uint8_t(septets[i] & 0x7fu);
+        uint32_t   u = gsm7_default[c];
+        if (c == gsm7_escape) {
+            if (i + 1 == count) break; // a lone escape at the end is padding
+            const auto e = uint8_t(septets[++i] & 0x7fu);
+            u            = gsm7_extension(e);
+            if (u == 0) u = gsm7_default[e];
+        }
+        if (!put_utf8(u, out, capacity, &n)) return -1;
+    }
+    return n;
+}
+
+int ucs2_to_utf8(const uint8_t* ucs2, int length, char* out, int capacity) {
+    int n = 0;
+    for (int i = 0; i + 1 < length; i += 2) {
+        uint32_t u = uint32_t(ucs2[i]) << 8u | ucs2[i + 1];
+        if (u >= 0xd800 && u <= 0xdfff) u = 0xfffd; // no surrogates in UCS-2
+        if (!put_utf8(u, out, capacity, &n)) return -1;
+    }
+    return n;
+}
+
+int network_name_text(const network_name_t& name, char* out, int capacity) {
+    return text_to_utf8(name.coding_scheme,
+                        name.unused_bits,
+                        name.text.data(),
+                        int(name.text.size()),
+                        out,
+                        capacity);
+}
+
+// octet 3 of 10.5.3.5a: ext, coding scheme, add CI and spare bits, then the text
+int network_name_text(const uint8_t* contents, int length, char* out, int capacity) {
+    if (!contents || length < 1) return -1;
+    return text_to_utf8((contents[0] >> 4u) & 0x07u,
+                        contents[0] & 0x07u,
+                        contents + 1,
+                        length - 1,
+                        out,
+                        capacity);
+}
+
+const std::string* network_name_cache::text(uint32_t       plmn,
+                                             bool           short_name,
+                                             const octet_t& contents) {
+    auto& e = entries[name_key(plmn, short_name)];
+    if (!e.contents.empty() && e.contents == contents) {
+        ++hits;
+        return &e.text;
+    }
+    ++misses;
+
+    char       buf[1024];
+    const auto n =
+        network_name_text(contents.data(), int(contents.size()), buf, int(sizeof(buf)));
+    if (n < 0) {
+        entries.erase(name_key(plmn, short_name));
+        return nullptr;
+    }
+    e.contents = contents;
+    e.text.assign(buf, size_t(n));
+    return &e.text;
+}
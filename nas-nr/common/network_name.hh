@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "ies.hh"
+
+// 10.5.3.5a in TS 24.008, coding scheme
+namespace network_name_coding {
+inline extern const uint8_t gsm7 = 0; // TS 23.038 default alphabet, packed
+inline extern const uint8_t ucs2 = 1;
+} // namespace network_name_coding
+
+/* TS 23.038 6.1.2.1 packed septets into one septet per octet, count is the number of
+ * characters the packed octets carry once spare_bits of the last octet are dropped.
+ * Seven octets at a time are spread into eight within a 64 bit register. Returns the
+ * number of septets, -1 when out is too small. */
+int gsm7_unpack(const uint8_t* packed,
+                int            length,
+                int            spare_bits,
+                uint8_t*       out,
+                int            capacity);
+
+// TS 23.038 6.2.1 default alphabet and its extension table to UTF-8, -1 when out is too
+// small
+int gsm7_to_utf8(const uint8_t* septets, int count, char* out, int capacity);
+
+// big endian UCS-2 to UTF-8, -1 when out is too small
+int ucs2_to_utf8(const uint8_t* ucs2, int length, char* out, int capacity);
+
+// text of a decoded network name as UTF-8, NUL terminated when there is room, -1 for an
+// unknown coding scheme or when out is too small
+int network_name_text(const network_name_t& name, char* out, int capacity);
+
+// the same for the contents of a full or short network name IE kept as octets
+int network_name_text(const uint8_t* contents, int length, char* out, int capacity);
+
+/* Decoded names per PLMN, the few names a network sends repeat in every configuration
+ * update command. An entry keeps the octets it was decoded from, so a changed name is
+ * decoded again and an unchanged one is only compared. */
+struct network_name_cache {
+    struct entry_t {
+        octet_t     contents = {};
+        std::string text     = {};
+    };
+
+    // UTF-8 text of a full (short_name false) or short network name IE for plmn, any key
+    // the caller groups by such as intern_plmn(), nullptr when it does not decode
+    const std::string* text(uint32_t plmn, bool short_name, const octet_t& contents);
+
+    std::unordered_map< uint64_t, entry_t > entries = {};
+    uint64_t                                hits    = 0;
+    uint64_t                                misses  = 0;
+};
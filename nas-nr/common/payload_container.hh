@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "messages.hh"
+
+struct updp_message_t;
+
+// 9.11.3.40 Payload container type
+namespace payload_container_kind {
+inline extern const uint8_t n1_sm_information    = 1;
+inline extern const uint8_t sms                  = 2;
+inline extern const uint8_t lpp                  = 3;
+inline extern const uint8_t sor                  = 4;
+inline extern const uint8_t ue_policy            = 5;
+inline extern const uint8_t ue_parameters_update = 6;
+inline extern const uint8_t location_services    = 7;
+inline extern const uint8_t ciot_user_data       = 8;
+inline extern const uint8_t multiple_payloads    = 15;
+} // namespace payload_container_kind
+
+// 9.11.3.39 optional IEs of a "multiple payloads" entry
+namespace payload_optional_ie {
+inline extern const uint8_t request_type           = 0x08;
+inline extern const uint8_t pdu_session_id         = 0x12;
+inline extern const uint8_t s_nssai                = 0x22;
+inline extern const uint8_t additional_information = 0x24;
+inline extern const uint8_t dnn                    = 0x25;
+inline extern const uint8_t backoff_timer          = 0x37;
+inline extern const uint8_t nmm_cause              = 0x58;
+inline extern const uint8_t old_pdu_session_id     = 0x59;
+} // namespace payload_optional_ie
+
+/* One payload of a payload container, pointers refer to the NAS buffer and are valid as
+ * long as it is. A container of any type but "multiple payloads" is a single entry with
+ * no optional IEs. */
+struct payload_entry_view {
+    uint8_t        type                = 0; // payload_container_kind
+    const uint8_t* contents            = nullptr;
+    int            length              = 0;
+    const uint8_t* optional_ies        = nullptr; // type, length and value each
+    int            optional_ies_length = 0;
+    uint8_t        optional_ies_n      = 0;
+
+    // value of an optional IE, false when the entry has none of that type
+    bool optional_ie(uint8_t type, const uint8_t** value, int* length) const;
+};
+
+// walks the entries of a payload container without copying, false at the end or on a
+// malformed entry, which also sets malformed
+struct payload_entry_iterator {
+    const uint8_t* p         = nullptr;
+    int            left      = 0;
+    int            entries   = 0; // still to come
+    uint8_t        type      = 0; // of the container
+    bool           malformed = false;
+
+    bool next(payload_entry_view* ret);
+};
+
+payload_entry_iterator payload_entries(uint8_t type, const uint8_t* contents, int length);
+payload_entry_iterator payload_entries(const ul_nas_transport_t& msg);
+payload_entry_iterator payload_entries(const dl_nas_transport_t& msg);
+
+// one entry decoded by its type, only the member of that type is set, SMS, LPP and the
+// other payloads NAS does not define are left as the entry view
+struct payload_t {
+    payload_entry_view                             entry     = {};
+    std::shared_ptr< nsm_message_t >               n1_sm     = {}; // 5GSM message
+    std::shared_ptr< sor_transparent_container_t > sor       = {};
+    std::shared_ptr< updp_message_t >              ue_policy = {}; // ue_policy.hh
+};
+
+result_t de_payload(const payload_entry_view& entry, context* ctx, payload_t* ret);
+
+/* Decodes the 5GSM message of an N1 SM information payload container straight from the
+ * NAS buffer, d is at the LV-E of the container. Nothing is decoded unless the container
+ * type is N1 SM information and the nesting stays within ctx->n1_sm_depth_limit. */
+result_t de_n1_sm_payload(dissector                         d,
+                          context*                          ctx,
+                          uint8_t                           type,
+                          std::shared_ptr< nsm_message_t >* ret);
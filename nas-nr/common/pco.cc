@@ -0,0 +1,117 @@
+#include "pco.hh"
+
+namespace {
+uint16_t be16(const uint8_t* p) { return uint16_t(p[0] << 8u | p[1]); }
+
+template < int n >
+void add(const uint8_t* (&to)[n], uint8_t* count, const uint8_t* address) {
+    if (*count < n) to[(*count)++] = address;
+}
+
+/* RFC 1332 IPCP packet: code, identifier, length, options of type, length and data.
+ * RFC 1877 primary (129) and secondary (131) DNS of a Configure-Ack or Configure-Nak */
+void ipcp_dns(const pco_option_view& v, pco_common_t* ret) {
+    if (v.length < 4) return;
+    const auto code = v.value[0];
+    if (code != 2 && code != 3) return;
+
+    auto l = int(be16(v.value + 2));
+    if (l > v.length) l = v.length;
+    const auto* p    = v.value + 4;
+    auto        left = l - 4;
+    while (left >= 2) {
+        const int ol = p[1];
+        if (ol < 2 || ol > left) return;
+        if ((p[0] == 129 || p[0] == 131) && ol == 6)
+            add(ret->dns_ipv4, &ret->dns_ipv4_n, p + 2);
+        p += ol;
+        left -= ol;
+    }
+}
+} // namespace
+
+pco_iterator pco_options(const uint8_t* contents, int length, bool extended) {
+    pco_iterator it;
+    it.extended = extended;
+    if (!contents || length < 1) return it;
+    it.p    = contents + 1;
+    it.left = length - 1;
+    return it;
+}
+
+pco_iterator pco_options(const octet_t& epco) {
+    return pco_options(epco.data(), int(epco.size()), true);
+}
+
+bool pco_iterator::next(pco_option_view* ret) {
+    if (malformed || left <= 0) return false;
+
+    const int header = extended ? 4 : 3;
+    if (left < header) {
+        malformed = true;
+        return false;
+    }
+    const int l = extended ? be16(p + 2) : p[2];
+    if (header + l > left) {
+        malformed = true;
+        return false;
+    }
+    ret->id     = be16(p);
+    ret->value  = p + header;
+    ret->length = l;
+    p += header + l;
+    left -= header + l;
+    return true;
+}
+
+bool pco_extract(const uint8_t* contents, int length, bool extended, pco_common_t* ret) {
+    namespace c = pco_container;
+
+    auto            it = pco_options(contents, length, extended);
+    pco_option_view v;
+    while (it.next(&v)) {
+        switch (v.id) {
+        case c::dns_ipv4:
+            if (v.length == 4) add(ret->dns_ipv4, &ret->dns_ipv4_n, v.value);
+            break;
+        case c::dns_ipv6:
+            if (v.length == 16) add(ret->dns_ipv6, &ret->dns_ipv6_n, v.value);
+            break;
+        case c::pcscf_ipv4:
+            if (v.length == 4) add(ret->pcscf_ipv4, &ret->pcscf_ipv4_n, v.value);
+            break;
+        case c::pcscf_ipv6:
+            if (v.length == 16) add(ret->pcscf_ipv6, &ret->pcscf_ipv6_n, v.value);
+            break;
+        case c::ipv4_link_mtu:
+            if (v.length == 2) ret->ipv4_mtu = be16(v.value);
+            break;
+        case c::non_ip_link_mtu:
+            if (v.length == 2) ret->non_ip_mtu = be16(v.value);
+            break;
+        case c::ethernet_mtu:
+            if (v.length == 2) ret->ethernet_mtu = be16(v.value);
+            break;
+        case c::unstructured_link_mtu:
+            if (v.length == 2) ret->unstructured_mtu = be16(v.value);
+            break;
+        case c::ip_address_via_nas:
+            ret->ip_address_via_nas = true;
+            break;
+        case c::im_cn_signaling_flag:
+            ret->im_cn_signaling = true;
+            break;
+        case pco_protocol::ipcp:
+            ipcp_dns(v, ret);
+            break;
+        default:
+            break;
+        }
+    }
+    ret->malformed = it.malformed;
+    return !it.malformed;
+}
+
+bool pco_extract(const octet_t& epco, pco_common_t* ret) {
+    return pco_extract(epco.data(), int(epco.size()), true, ret);
+}
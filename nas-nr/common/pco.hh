@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+
+#include "definitions.hh"
+
+// TS 24.008 10.5.6.3 Table 10.5.154 container identifiers, those of one direction only
+// are marked
+namespace pco_container {
+inline extern const uint16_t pcscf_ipv6               = 0x0001;
+inline extern const uint16_t im_cn_signaling_flag     = 0x0002;
+inline extern const uint16_t dns_ipv6                 = 0x0003;
+inline extern const uint16_t policy_control_rejection = 0x0004; // network to UE
+inline extern const uint16_t bearer_control_mode      = 0x0005;
+inline extern const uint16_t ip_address_via_nas       = 0x000a; // UE to network
+inline extern const uint16_t ipv4_address_via_dhcp    = 0x000b; // UE to network
+inline extern const uint16_t pcscf_ipv4               = 0x000c;
+inline extern const uint16_t dns_ipv4                 = 0x000d;
+inline extern const uint16_t msisdn                   = 0x000e;
+inline extern const uint16_t ipv4_link_mtu            = 0x0010;
+inline extern const uint16_t pcscf_reselection        = 0x0012; // UE to network
+inline extern const uint16_t nbifom_mode              = 0x0014;
+inline extern const uint16_t non_ip_link_mtu          = 0x0015;
+inline extern const uint16_t apn_rate_control         = 0x0016;
+inline extern const uint16_t ps_data_off_ue_status    = 0x0017; // support indication DL
+inline extern const uint16_t pdu_session_id           = 0x001a; // UE to network
+inline extern const uint16_t ethernet_mtu             = 0x0020;
+inline extern const uint16_t unstructured_link_mtu    = 0x0021;
+inline extern const uint16_t nsm_cause                = 0x0022; // UE to network
+} // namespace pco_container
+
+// TS 24.008 10.5.6.3 protocol identifiers
+namespace pco_protocol {
+inline extern const uint16_t lcp  = 0xc021;
+inline extern const uint16_t pap  = 0xc023;
+inline extern const uint16_t chap = 0xc223;
+inline extern const uint16_t ipcp = 0x8021;
+} // namespace pco_protocol
+
+// one protocol or container of a PCO or ePCO, value points into the IE contents
+struct pco_option_view {
+    uint16_t       id     = 0;
+    const uint8_t* value  = nullptr;
+    int            length = 0;
+};
+
+/* Walks the options of a PCO or ePCO without copying, false at the end or on an option
+ * that runs past the contents, which also sets malformed. An ePCO (extended) codes the
+ * length of each option in two octets, a PCO in one. */
+struct pco_iterator {
+    const uint8_t* p         = nullptr;
+    int            left      = 0;
+    bool           extended  = false;
+    bool           malformed = false;
+
+    bool next(pco_option_view* ret);
+};
+
+// contents start with the octet of ext bit and configuration protocol
+pco_iterator pco_options(const uint8_t* contents, int length, bool extended);
+pco_iterator pco_options(const octet_t& epco); // 9.11.4.6 contents
+
+/* The options read from every PDU session establishment accept, in one pass. Addresses
+ * point into the IE contents, 4 octets for IPv4 and 16 for IPv6; IPCP Configure-Nak and
+ * Configure-Ack primary and secondary DNS count as DNS IPv4 addresses. Addresses past
+ * the first four of a kind are left out. */
+struct pco_common_t {
+    const uint8_t* dns_ipv4[4]        = {};
+    const uint8_t* dns_ipv6[4]        = {};
+    const uint8_t* pcscf_ipv4[4]      = {};
+    const uint8_t* pcscf_ipv6[4]      = {};
+    uint8_t        dns_ipv4_n         = 0;
+    uint8_t        dns_ipv6_n         = 0;
+    uint8_t        pcscf_ipv4_n       = 0;
+    uint8_t        pcscf_ipv6_n       = 0;
+    uint16_t       ipv4_mtu           = 0; // 0 when absent
+    uint16_t       non_ip_mtu         = 0;
+    uint16_t       ethernet_mtu       = 0;
+    uint16_t       unstructured_mtu   = 0;
+    bool           ip_address_via_nas = false;
+    bool           im_cn_signaling    = false;
+    bool           malformed          = false;
+};
+
+// false when the options ended in a malformed one, those before it are kept
+bool pco_extract(const uint8_t* contents, int length, bool extended, pco_common_t* ret);
+bool pco_extract(const octet_t& epco, pco_common_t* ret);
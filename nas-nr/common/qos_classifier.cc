@@ -0,0 +1,304 @@
+#include "qos_classifier.hh"
+
+#include <algorithm>
+
+#include "packet.hh"
+
+namespace {
+namespace field {
+const uint32_t v4_remote   = 1u << 0u;
+const uint32_t v4_local    = 1u << 1u;
+const uint32_t v6_remote   = 1u << 2u;
+const uint32_t v6_local    = 1u << 3u;
+const uint32_t protocol    = 1u << 4u;
+const uint32_t local_port  = 1u << 5u;
+const uint32_t remote_port = 1u << 6u;
+const uint32_t spi         = 1u << 7u;
+const uint32_t tos         = 1u << 8u;
+const uint32_t flow_label  = 1u << 9u;
+const uint32_t dst_mac     = 1u << 10u;
+const uint32_t src_mac     = 1u << 11u;
+const uint32_t ctag_vid    = 1u << 12u;
+const uint32_t stag_vid    = 1u << 13u;
+const uint32_t ctag_pcp    = 1u << 14u;
+const uint32_t stag_pcp    = 1u << 15u;
+const uint32_t ethertype   = 1u << 16u;
+
+const uint32_t ipv4 = v4_remote | v4_local;
+const uint32_t ipv6 = v6_remote | v6_local | flow_label;
+const uint32_t ip   = ipv4 | ipv6 | protocol | local_port | remote_port | spi | tos;
+} // namespace field
+
+uint64_t be64(const uint8_t* p, int n) {
+    uint64_t v = 0;
+    for (auto i = 0; i < n; ++i) v = v << 8u | p[i];
+    return v;
+}
+
+// 9.11.4.13 packet filter direction
+uint8_t directions(uint8_t v) {
+    uint8_t ret = 0;
+    if (v & 0x01u) ret |= 1u << direction::dl;
+    if (v & 0x02u) ret |= 1u << direction::ul;
+    return ret;
+}
+
+void prefix_mask(uint8_t prefix_length, uint64_t mask[2]) {
+    const auto n = prefix_length > 128 ? 128u : uint32_t(prefix_length);
+    mask[0]      = n == 0 ? 0 : n >= 64 ? ~uint64_t(0) : ~uint64_t(0) << (64u - n);
+    mask[1]      = n <= 64 ? 0 : n >= 128 ? ~uint64_t(0) : ~uint64_t(0) << (128u - n);
+}
+
+void ipv6_match(const packet_filter_components_t::ipv6_t& v,
+                uint64_t                                  a[2],
+                uint64_t                                  m[2]) {
+    prefix_mask(v.prefix_length, m);
+    a[0] = be64(v.address, 8) & m[0];
+    a[1] = be64(v.address + 8, 8) & m[1];
+}
+
+qos_classifier::match_t compile(const qos_rule_set::rule_t&            rule,
+                                const qos_rule_t::packet_filter_add_t& filter) {
+    const auto&             c = filter.components;
+    qos_classifier::match_t m;
+    m.directions = directions(filter.direction);
+    m.qfi        = rule.qfi;
+    m.precedence = rule.precedence;
+    m.rule       = rule.id;
+    m.filter     = filter.id;
+
+    if (c.ipv4_remote.present) {
+        m.fields |= field::v4_remote;
+        m.v4_remote_m = uint32_t(be64(c.ipv4_remote.v.mask, 4));
+        m.v4_remote   = uint32_t(be64(c.ipv4_remote.v.address, 4)) & m.v4_remote_m;
+    }
+    if (c.ipv4_local.present) {
+        m.fields |= field::v4_local;
+        m.v4_local_m = uint32_t(be64(c.ipv4_local.v.mask, 4));
+        m.v4_local   = uint32_t(be64(c.ipv4_local.v.address, 4)) & m.v4_local_m;
+    }
+    if (c.ipv6_remote.present) {
+        m.fields |= field::v6_remote;
+        ipv6_match(c.ipv6_remote.v, m.v6_remote, m.v6_remote_m);
+    }
+    if (c.ipv6_local.present) {
+        m.fields |= field::v6_local;
+        ipv6_match(c.ipv6_local.v, m.v6_local, m.v6_local_m);
+    }
+    if (c.protocol.present) {
+        m.fields |= field::protocol;
+        m.protocol = c.protocol.v;
+    }
+    if (c.local_port.present) {
+        m.fields |= field::local_port;
+        m.local_lo = c.local_port.v.low;
+        m.local_hi = c.local_port.v.high;
+    }
+    if (c.remote_port.present) {
+        m.fields |= field::remote_port;
+        m.remote_lo = c.remote_port.v.low;
+        m.remote_hi = c.remote_port.v.high;
+    }
+    if (c.spi.present) {
+        m.fields |= field::spi;
+        m.spi = c.spi.v;
+    }
+    if (c.tos.present) {
+        m.fields |= field::tos;
+        m.tos_mask = c.tos.v.mask;
+        m.tos      = c.tos.v.value & c.tos.v.mask;
+    }
+    if (c.flow_label.present) {
+        m.fields |= field::flow_label;
+        m.flow_label = c.flow_label.v;
+    }
+    if (c.dst_mac.present) {
+        m.fields |= field::dst_mac;
+        m.dst_mac_lo = be64(c.dst_mac.v.low, 6);
+        m.dst_mac_hi = be64(c.dst_mac.v.high, 6);
+    }
+    if (c.src_mac.present) {
+        m.fields |= field::src_mac;
+        m.src_mac_lo = be64(c.src_mac.v.low, 6);
+        m.src_mac_hi = be64(c.src_mac.v.high, 6);
+    }
+    if (c.ctag_vid.present) {
+        m.fields |= field::ctag_vid;
+        m.ctag_vid = c.ctag_vid.v;
+    }
+    if (c.stag_vid.present) {
+        m.fields |= field::stag_vid;
+        m.stag_vid = c.stag_vid.v;
+    }
+    if (c.ctag_pcp_dei.present) {
+        m.fields |= field::ctag_pcp;
+        m.ctag_pcp = c.ctag_pcp_dei.v;
+    }
+    if (c.stag_pcp_dei.present) {
+        m.fields |= field::stag_pcp;
+        m.stag_pcp = c.stag_pcp_dei.v;
+    }
+    if (c.ethertype.present) {
+        m.fields |= field::ethertype;
+        m.ethertype = c.ethertype.v;
+    }
+    return m;
+}
+
+// the packet in the shape of a match entry, so that every check is a compare
+struct packet_key {
+    uint32_t v4_local     = 0;
+    uint32_t v4_remote    = 0;
+    uint64_t v6_local[2]  = {};
+    uint64_t v6_remote[2] = {};
+    uint64_t dst_mac      = 0;
+    uint64_t src_mac      = 0;
+};
+
+bool prefix_equal(const uint64_t v[2], const uint64_t a[2], const uint64_t m[2]) {
+    return (v[0] & m[0]) == a[0] && (v[1] & m[1]) == a[1];
+}
+
+bool match(const qos_classifier::match_t& m, const qos_packet_t& p, const packet_key& k) {
+    const auto f = m.fields;
+    if (!(m.directions & (1u << uint32_t(p.dir)))) return false;
+    if (f == 0) return true; // match-all
+
+    if ((f & field::ip) && p.ip_version == 0) return false;
+    if ((f & field::ipv4) && p.ip_version != 4) return false;
+    if ((f & field::ipv6) && p.ip_version != 6) return false;
+
+    if ((f & field::protocol) && p.protocol != m.protocol) return false;
+    if ((f & field::v4_remote) && (k.v4_remote & m.v4_remote_m) != m.v4_remote)
+        return false;
+    if ((f & field::v4_local) && (k.v4_local & m.v4_local_m) != m.v4_local) return false;
+    if ((f & field::v6_remote) && !prefix_equal(k.v6_remote, m.v6_remote, m.v6_remote_m))
+        return false;
+    if ((f & field::v6_local) && !prefix_equal(k.v6_local, m.v6_local, m.v6_local_m))
+        return false;
+    if ((f & field::local_port) &&
+        (p.local_port < m.local_lo || p.local_port > m.local_hi))
+        return false;
+    if ((f & field::remote_port) &&
+        (p.remote_port < m.remote_lo || p.remote_port > m.remote_hi))
+        return false;
+    if ((f & field::spi) && p.spi != m.spi) return false;
+    if ((f & field::tos) && (p.tos & m.tos_mask) != m.tos) return false;
+    if ((f & field::flow_label) && p.flow_label != m.flow_label) return false;
+
+    if ((f & field::dst_mac) && (k.dst_mac < m.dst_mac_lo || k.dst_mac > m.dst_mac_hi))
+        return false;
+    if ((f & field::src_mac) && (k.src_mac < m.src_mac_lo || k.src_mac > m.src_mac_hi))
+        return false;
+    if ((f & field::ctag_vid) && (!p.ctag || p.ctag_vid != m.ctag_vid)) return false;
+    if ((f & field::stag_vid) && (!p.stag || p.stag_vid != m.stag_vid)) return false;
+    if ((f & field::ctag_pcp) && (!p.ctag || p.ctag_pcp_dei != m.ctag_pcp)) return false;
+    if ((f & field::stag_pcp) && (!p.stag || p.stag_pcp_dei != m.stag_pcp)) return false;
+    if ((f & field::ethertype) && p.ethertype != m.ethertype) return false;
+    return true;
+}
+
+void erase_filter(std::vector< qos_rule_t::packet_filter_add_t >& filters, uint8_t id) {
+    filters.erase(std::remove_if(filters.begin(),
+                                 filters.end(),
+                                 [id](const auto& f) { return f.id == id; }),
+                  filters.end());
+}
+} // namespace
+
+const qos_rule_set::rule_t* qos_rule_set::find(uint8_t id) const {
+    for (const auto& r : rules)
+        if (r.id == id) return &r;
+    return nullptr;
+}
+
+void qos_rule_set::apply(const qos_rules_t& qos_rules) {
+    namespace op = qos_rule_operation;
+    for (const auto& q : qos_rules.rules) {
+        auto it = std::find_if(
+            rules.begin(), rules.end(), [&q](const rule_t& r) { return r.id == q.id; });
+
+        if (q.rule_operation_code == op::remove) {
+            if (it != rules.end()) rules.erase(it);
+            continue;
+        }
+        if (q.rule_operation_code == op::create) {
+            if (it == rules.end()) it = rules.insert(rules.end(), rule_t{});
+            *it    = rule_t{};
+            it->id = q.id;
+        } else if (it == rules.end()) {
+            continue; // modifies a rule never created
+        }
+
+        auto& r = *it;
+        r.dqr   = q.dqr;
+        if (q.precedence.present) r.precedence = q.precedence.v;
+        if (q.qos_flow_id.present) r.qfi = q.qos_flow_id.v;
+
+        switch (q.rule_operation_code) {
+        case op::replace_packet_filters:
+            r.filters.clear();
+            // fall through
+        case op::create:
+        case op::add_packet_filters:
+            // a filter reusing an identifier replaces the old one
+            for (const auto& f : q.add_packets) {
+                erase_filter(r.filters, f.id);
+                r.filters.push_back(f);
+            }
+            break;
+        case op::delete_packet_filters:
+            for (const auto id : q.delete_packets) erase_filter(r.filters, id);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+qos_classifier::qos_classifier(const qos_rule_set& rules) {
+    for (const auto& r : rules.rules) {
+        if (r.filters.empty()) {
+            if (r.dqr) default_qfi = r.qfi;
+            continue;
+        }
+        for (const auto& f : r.filters) matches.push_back(compile(r, f));
+    }
+    // lower precedence values are evaluated first
+    auto before = [](const match_t& a, const match_t& b) {
+        if (a.precedence != b.precedence) return a.precedence < b.precedence;
+        if (a.rule != b.rule) return a.rule < b.rule;
+        return a.filter < b.filter;
+    };
+    std::stable_sort(matches.begin(), matches.end(), before);
+
+    for (uint32_t p = 0; p < 256; ++p) {
+        offsets[p] = uint32_t(index.size());
+        for (uint32_t i = 0; i < matches.size(); ++i) {
+            const auto& m = matches[i];
+            if (!(m.fields & field::protocol) || m.protocol == p) index.push_back(i);
+        }
+    }
+    offsets[256] = uint32_t(index.size());
+}
+
+int qos_classifier::classify(const qos_packet_t& pkt) const {
+    packet_key k;
+    if (pkt.ip_version == 4) {
+        k.v4_local  = uint32_t(be64(pkt.local, 4));
+        k.v4_remote = uint32_t(be64(pkt.remote, 4));
+    } else if (pkt.ip_version == 6) {
+        k.v6_local[0]  = be64(pkt.local, 8);
+        k.v6_local[1]  = be64(pkt.local + 8, 8);
+        k.v6_remote[0] = be64(pkt.remote, 8);
+        k.v6_remote[1] = be64(pkt.remote + 8, 8);
+    }
+    k.dst_mac = be64(pkt.dst_mac, 6);
+    k.src_mac = be64(pkt.src_mac, 6);
+
+    const auto* m = matches.data();
+    for (auto i = offsets[pkt.protocol]; i < offsets[pkt.protocol + 1]; ++i) {
+        if (match(m[index[i]], pkt, k)) return m[index[i]].qfi;
+    }
+    return default_qfi;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "ies.hh"
+
+// QoS rules of one PDU session as left by the 9.11.4.13 rule operations seen so far
+struct qos_rule_set {
+    struct rule_t {
+        uint8_t                                        id         = 0;
+        uint8_t                                        dqr        = 0; // default QoS rule
+        uint8_t                                        precedence = 0;
+        uint8_t                                        qfi        = 0;
+        std::vector< qos_rule_t::packet_filter_add_t > filters    = {};
+    };
+
+    // applies the operation code of each rule, in order
+    void apply(const qos_rules_t& rules);
+
+    const rule_t* find(uint8_t id) const;
+
+    std::vector< rule_t > rules = {};
+};
+
+// one packet to classify, addresses and ports are seen from the UE: for an uplink packet
+// local is the source, for a downlink packet local is the destination
+struct qos_packet_t {
+    int      dir          = 0; // direction::ul or direction::dl
+    uint8_t  ip_version   = 0; // 4 or 6, 0 for a frame without an IP header
+    uint8_t  local[16]    = {}; // IPv4 addresses use the first 4 octets
+    uint8_t  remote[16]   = {};
+    uint8_t  protocol     = 0; // protocol / next header
+    uint16_t local_port   = 0;
+    uint16_t remote_port  = 0;
+    uint32_t spi          = 0;
+    uint8_t  tos          = 0; // type of service / traffic class
+    uint32_t flow_label   = 0;
+    uint8_t  dst_mac[6]   = {};
+    uint8_t  src_mac[6]   = {};
+    bool     ctag         = false; // 802.1Q C-TAG present
+    bool     stag         = false; // 802.1ad S-TAG present
+    uint16_t ctag_vid     = 0;
+    uint16_t stag_vid     = 0;
+    uint8_t  ctag_pcp_dei = 0;
+    uint8_t  stag_pcp_dei = 0;
+    uint16_t ethertype    = 0;
+};
+
+/* Packet filters of a qos_rule_set flattened into precedence order (TS 23.501 5.7.1.5).
+ * Every filter is compiled into a fixed size match entry with a bit per component it
+ * checks, and entries are indexed by protocol, filters that do not check the protocol
+ * appear under every protocol, so classify() only visits filters that can match. */
+struct qos_classifier {
+    struct match_t {
+        uint32_t fields         = 0; // components checked
+        uint8_t  directions     = 0; // 1 << direction::ul | 1 << direction::dl
+        uint8_t  qfi            = 0;
+        uint8_t  precedence     = 0;
+        uint8_t  rule           = 0;
+        uint8_t  filter         = 0;
+        uint8_t  protocol       = 0;
+        uint8_t  tos            = 0;
+        uint8_t  tos_mask       = 0;
+        uint32_t v4_remote      = 0; // already masked, host order
+        uint32_t v4_remote_m    = 0;
+        uint32_t v4_local       = 0;
+        uint32_t v4_local_m     = 0;
+        uint64_t v6_remote[2]   = {}; // already masked, host order
+        uint64_t v6_remote_m[2] = {};
+        uint64_t v6_local[2]    = {};
+        uint64_t v6_local_m[2]  = {};
+        uint16_t local_lo       = 0;
+        uint16_t local_hi       = 0;
+        uint16_t remote_lo      = 0;
+        uint16_t remote_hi      = 0;
+        uint32_t spi            = 0;
+        uint32_t flow_label     = 0;
+        uint64_t dst_mac_lo     = 0;
+        uint64_t dst_mac_hi     = 0;
+        uint64_t src_mac_lo     = 0;
+        uint64_t src_mac_hi     = 0;
+        uint16_t ctag_vid       = 0;
+        uint16_t stag_vid       = 0;
+        uint8_t  ctag_pcp       = 0;
+        uint8_t  stag_pcp       = 0;
+        uint16_t ethertype      = 0;
+    };
+
+    explicit qos_classifier(const qos_rule_set& rules);
+
+    // QFI of the first matching filter, the QFI of a default rule without filters when
+    // nothing matches, -1 otherwise
+    int classify(const qos_packet_t& pkt) const;
+
+    std::vector< match_t >  matches      = {}; // precedence order
+    std::vector< uint32_t > index        = {}; // matches per protocol
+    uint32_t                offsets[257] = {}; // index[offsets[p], offsets[p + 1]) for p
+    int                     default_qfi  = -1;
+};
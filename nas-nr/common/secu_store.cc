@@ -0,0 +1,466 @@
+#include "secu_store.hh"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "context.hh"
+#include "core.hh"
+#include "ies.hh"
+#include "messages.hh"
+#include "nas_count.hh"
+
+namespace {
+// index slot: a key and what it refers to, meta 0 marks an empty slot
+struct secu_slot {
+    uint64_t value = 0;
+    uint64_t meta  = 0; // kind << 56 | gen << 40 | shard << 28 | entry index
+};
+
+const uint32_t max_shards     = 1u << 12u;
+const uint32_t max_entries    = 1u << 28u;
+const uint32_t keys_per_entry = 4; // SUCI, 5G-GUTI, 5G-S-TMSI and RAN UE NGAP ID
+
+const uint8_t flag_nksi      = 0x0fu;
+const uint8_t flag_activated = 0x10u;
+const uint8_t flag_ul_seen   = 0x20u; // a COUNT was taken in, nas_count.hh
+const uint8_t flag_dl_seen   = 0x40u;
+const uint8_t flag_in_use    = 0x80u;
+const uint8_t flag_pending   = 0x80u; // of pending_nksi
+
+// an entry is copied in and out of the shard a word at a time
+const uint32_t entry_words = sizeof(secu_entry) / sizeof(uint32_t);
+static_assert(sizeof(secu_entry) % sizeof(uint32_t) == 0, "secu_entry in whole words");
+
+uint64_t make_meta(uint8_t kind, uint16_t gen, uint32_t shard, uint32_t index) {
+    return uint64_t(kind) << 56u | uint64_t(gen) << 40u | uint64_t(shard) << 28u | index;
+}
+uint8_t  meta_kind(uint64_t meta) { return uint8_t(meta >> 56u); }
+uint16_t meta_gen(uint64_t meta) { return uint16_t(meta >> 40u); }
+uint32_t meta_shard(uint64_t meta) { return uint32_t(meta >> 28u) & (max_shards - 1); }
+uint32_t meta_index(uint64_t meta) { return uint32_t(meta) & (max_entries - 1); }
+
+// splitmix64 finalizer
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30u;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27u;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31u);
+}
+
+uint64_t hash_of(uint8_t kind, uint64_t value) { return mix64(value ^ uint64_t(kind) << 56u); }
+
+uint64_t fnv1a(uint64_t h, const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ULL;
+    return h;
+}
+uint64_t fnv1a(uint64_t h, uint32_t v) {
+    const uint8_t b[] = {uint8_t(v >> 24u), uint8_t(v >> 16u), uint8_t(v >> 8u), uint8_t(v)};
+    return fnv1a(h, b, sizeof(b));
+}
+
+uint32_t next_pow2(uint32_t v) {
+    uint32_t r = 1;
+    while (r < v) r <<= 1u;
+    return r;
+}
+
+void pack(const nr_security_context& ctx, uint32_t now, secu_entry* e) {
+    memcpy(e->cyphering_key, ctx.cyphering_key, sizeof(e->cyphering_key));
+    memcpy(e->integrity_key, ctx.integrity_key, sizeof(e->integrity_key));
+    memcpy(e->kausf, ctx.kausf, sizeof(e->kausf));
+    e->ul_count   = nas_count(ctx.ul_count_overflow, ctx.ul_count_seq_no);
+    e->dl_count   = nas_count(ctx.dl_count_overflow, ctx.dl_count_seq_no);
+    e->algorithms = uint8_t(ctx.selected_algorithm.ciphering_type << 4u |
+                            (ctx.selected_algorithm.integrity_type & 0x0fu));
+    e->flags      = uint8_t((e->flags & flag_in_use) | (ctx.nas_ksi & flag_nksi) |
+                       (ctx.activated ? flag_activated : 0) |
+                       (ctx.ul_count_seen ? flag_ul_seen : 0) |
+                       (ctx.dl_count_seen ? flag_dl_seen : 0));
+    e->last_seen  = now;
+}
+
+void unpack(const secu_entry& e, nr_security_context* ctx) {
+    memcpy(ctx->cyphering_key, e.cyphering_key, sizeof(e.cyphering_key));
+    memcpy(ctx->integrity_key, e.integrity_key, sizeof(e.integrity_key));
+    memcpy(ctx->kausf, e.kausf, sizeof(e.kausf));
+    ctx->ul_count_overflow                 = e.ul_count >> 8u;
+    ctx->ul_count_seq_no                   = e.ul_count & 0xffu;
+    ctx->dl_count_overflow                 = e.dl_count >> 8u;
+    ctx->dl_count_seq_no                   = e.dl_count & 0xffu;
+    ctx->selected_algorithm.ciphering_type = e.algorithms >> 4u;
+    ctx->selected_algorithm.integrity_type = e.algorithms & 0x0fu;
+    ctx->nas_ksi                           = e.flags & flag_nksi;
+    ctx->activated                         = (e.flags & flag_activated) ? 1 : 0;
+    ctx->ul_count_seen                     = (e.flags & flag_ul_seen) != 0;
+    ctx->dl_count_seen                     = (e.flags & flag_dl_seen) != 0;
+}
+
+bool alive(const secu_entry& e, uint64_t meta) {
+    return (e.flags & flag_in_use) && e.gen == meta_gen(meta);
+}
+} // namespace
+
+/* Entries and slots are sized once and never move. Both are held as atomic words read and
+ * written relaxed, so a reader racing a writer can at worst see torn data, which the
+ * sequence counter then rejects. Writers copy out, change and copy back under the
+ * lock. */
+struct secu_store::shard {
+    using word_t = std::atomic< uint32_t >;
+    using slot_t = std::atomic< uint64_t >;
+
+    std::atomic< uint32_t >     seq          = {0}; // odd while a writer is inside
+    std::atomic< uint32_t >     used_entries = {0};
+    std::mutex                  lock         = {};
+    uint32_t                    slot_count   = 0; // power of two, linear probing
+    uint32_t                    entry_count  = 0;
+    std::unique_ptr< slot_t[] > slot_words   = {}; // value, meta of each slot
+    std::unique_ptr< word_t[] > entry_data   = {}; // entry_words of each entry
+    std::vector< uint32_t >     free_entries = {};
+    uint32_t                    used_slots   = 0;
+    uint32_t                    retired      = 0; // entries whose generation ran out
+
+    secu_slot slot(uint32_t i) const {
+        return {slot_words[2 * i].load(std::memory_order_relaxed),
+                slot_words[2 * i + 1].load(std::memory_order_relaxed)};
+    }
+    void set_slot(uint32_t i, const secu_slot& v) {
+        slot_words[2 * i].store(v.value, std::memory_order_relaxed);
+        slot_words[2 * i + 1].store(v.meta, std::memory_order_relaxed);
+    }
+
+    secu_entry entry(uint32_t i) const {
+        uint32_t w[entry_words];
+        for (uint32_t k = 0; k < entry_words; ++k)
+            w[k] = entry_words_of(i)[k].load(std::memory_order_relaxed);
+        secu_entry e;
+        memcpy(&e, w, sizeof(e));
+        return e;
+    }
+    void set_entry(uint32_t i, const secu_entry& e) {
+        uint32_t w[entry_words];
+        memcpy(w, &e, sizeof(e));
+        for (uint32_t k = 0; k < entry_words; ++k)
+            entry_words_of(i)[k].store(w[k], std::memory_order_relaxed);
+    }
+    word_t* entry_words_of(uint32_t i) const {
+        return &entry_data[size_t(i) * entry_words];
+    }
+
+    // drops the entry, it goes back to the pool unless its generation would wrap
+    void recycle(uint32_t i) {
+        auto e  = entry(i);
+        e.flags = 0;
+        ++e.gen;
+        set_entry(i, e);
+        used_entries.fetch_sub(1, std::memory_order_relaxed);
+        if (e.gen == 0) {
+            ++retired;
+            return;
+        }
+        free_entries.push_back(i);
+    }
+
+    // runs f until it completes without a writer getting in between
+    template < typename F >
+    bool optimistic(F&& f) const {
+        for (;;) {
+            const auto before = seq.load(std::memory_order_acquire);
+            if (before & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            const bool ret = f(); // relaxed loads only
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == before) return ret;
+        }
+    }
+
+    // slot holding key, or the empty slot ending its probe sequence, or -1 when full
+    int probe(uint8_t kind, uint64_t value, uint64_t hash) const {
+        const auto mask = slot_count - 1;
+        auto       i    = uint32_t(hash) & mask;
+        for (uint32_t n = 0; n <= mask; ++n, i = (i + 1) & mask) {
+            const auto s = slot(i);
+            if (s.meta == 0) return int(i);
+            if (meta_kind(s.meta) == kind && s.value == value) return int(i);
+        }
+        return -1;
+    }
+
+    // backward shift deletion, keeps probe sequences intact without tombstones
+    void erase(uint32_t i) {
+        const auto mask = slot_count - 1;
+        auto       j    = i;
+        for (;;) {
+            j              = (j + 1) & mask;
+            const auto s_j = slot(j);
+            if (s_j.meta == 0) break;
+            const auto home  = uint32_t(hash_of(meta_kind(s_j.meta), s_j.value)) & mask;
+            const bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+            if (stays) continue;
+            set_slot(i, s_j);
+            i = j;
+        }
+        set_slot(i, {});
+        --used_slots;
+    }
+};
+
+namespace {
+struct write_section {
+    secu_store::shard* s;
+
+    explicit write_section(secu_store::shard* s) : s(s) {
+        s->lock.lock();
+        s->seq.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    ~write_section() {
+        s->seq.fetch_add(1, std::memory_order_release);
+        s->lock.unlock();
+    }
+    write_section(const write_section&) = delete;
+    write_section& operator=(const write_section&) = delete;
+};
+
+uint32_t shard_of(const secu_store* store, uint64_t hash) {
+    return uint32_t(hash >> 40u) % uint32_t(store->shards.size());
+}
+
+// key's slot meta, lock free
+bool resolve(const secu_store* store, const secu_key& key, uint64_t* meta) {
+    const auto  hash = hash_of(key.kind, key.value);
+    const auto& s    = *store->shards[shard_of(store, hash)];
+    return s.optimistic([&] {
+        const auto i = s.probe(key.kind, key.value, hash);
+        *meta        = i < 0 ? 0 : s.slot(uint32_t(i)).meta;
+        return *meta != 0;
+    });
+}
+
+// copy of the entry meta refers to, lock free
+bool read(const secu_store* store, uint64_t meta, secu_entry* entry) {
+    const auto& s = *store->shards[meta_shard(meta)];
+    return s.optimistic([&] {
+        *entry = s.entry(meta_index(meta));
+        return alive(*entry, meta);
+    });
+}
+
+// points key at the entry meta refers to, replacing expected if the slot holds it
+bool link(secu_store* store, const secu_key& key, uint64_t meta, uint64_t expected) {
+    const auto hash = hash_of(key.kind, key.value);
+    auto*      s    = store->shards[shard_of(store, hash)].get();
+
+    const write_section w(s);
+    const auto          i = s->probe(key.kind, key.value, hash);
+    if (i < 0) return false;
+    const auto was = s->slot(uint32_t(i)).meta;
+    if (was != 0 && was != expected) return false;
+    if (was == 0) {
+        if ((s->used_slots + 1) * 8 > uint64_t(s->slot_count) * 7) return false;
+        ++s->used_slots;
+    }
+    const auto to = (meta & ~(uint64_t(0xff) << 56u)) | uint64_t(key.kind) << 56u;
+    s->set_slot(uint32_t(i), {key.value, to});
+    return true;
+}
+} // namespace
+
+secu_key guti_key(const guti_nmid_t& guti) {
+    // 76 bits do not fit: AMF ID and 5G-TMSI are kept whole, the PLMN is folded into the
+    // top octet
+    const auto plmn = uint64_t(guti.mccmnc.mcc) * 1000 + guti.mccmnc.mnc;
+    const auto low  = uint64_t(guti.amf_region_id) << 48u |
+                     uint64_t(guti.amf_set_id & 0x3ffu) << 38u |
+                     uint64_t(guti.amf_pointer & 0x3fu) << 32u | n2uint32(guti.tmsi);
+    return {secu_key_kind::guti, (mix64(plmn) & 0xff00000000000000ULL) | low};
+}
+
+secu_key s_tmsi_key(const s_tmsi_nmid_t& stmsi) {
+    return {secu_key_kind::s_tmsi,
+            uint64_t(stmsi.amf_set_id & 0x3ffu) << 38u |
+                uint64_t(stmsi.amf_pointer & 0x3fu) << 32u | n2uint32(stmsi.tmsi)};
+}
+
+secu_key suci_key(const suci_nmid_t& suci) {
+    auto h = fnv1a(0xcbf29ce484222325ULL, suci.supi_format);
+    if (suci.imsi) {
+        const auto& imsi = *suci.imsi;
+        h                = fnv1a(h, uint32_t(imsi.mccmnc.mcc) << 16u | imsi.mccmnc.mnc);
+        h = fnv1a(h, imsi.routing_indicator, sizeof(imsi.routing_indicator));
+        h = fnv1a(h, uint32_t(imsi.protection_scheme_id) << 8u | imsi.home_network_public_key_id);
+        if (imsi.scheme_output) h = fnv1a(h, imsi.scheme_output->data(), imsi.scheme_output->size());
+        if (imsi.msin) h = fnv1a(h, imsi.msin->data(), imsi.msin->size());
+    } else if (suci.nai) {
+        h = fnv1a(h, suci.nai->suci_nai.data(), suci.nai->suci_nai.size());
+    }
+    return {secu_key_kind::suci, h};
+}
+
+secu_key ran_ue_ngap_key(uint32_t ran_ue_ngap_id, uint32_t gnb_id) {
+    return {secu_key_kind::ran_ue_ngap_id, uint64_t(gnb_id) << 32u | ran_ue_ngap_id};
+}
+
+secu_store::secu_store(uint32_t capacity, uint32_t count) {
+    if (count == 0) count = 1;
+    if (count > max_shards) count = max_shards;
+
+    // a quarter of headroom for keys hashing unevenly onto shards
+    auto per_shard = capacity / count + capacity / count / 4 + 16;
+    if (per_shard > max_entries) per_shard = max_entries;
+
+    shards.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto s         = std::make_unique< shard >();
+        s->slot_count  = next_pow2(per_shard * keys_per_entry);
+        s->entry_count = per_shard;
+        // value initialized, all zero
+        const auto words = size_t(per_shard) * entry_words;
+        s->slot_words    = std::make_unique< shard::slot_t[] >(size_t(s->slot_count) * 2);
+        s->entry_data    = std::make_unique< shard::word_t[] >(words);
+        s->free_entries.reserve(per_shard);
+        for (auto j = per_shard; j > 0; --j) s->free_entries.push_back(j - 1);
+        shards.push_back(std::move(s));
+    }
+}
+
+secu_store::~secu_store() = default;
+
+bool secu_store::find(const secu_key& key, nr_security_context* ctx) const {
+    uint64_t   meta  = 0;
+    secu_entry entry = {};
+    if (!resolve(this, key, &meta) || !read(this, meta, &entry)) return false;
+    if (ctx) unpack(entry, ctx);
+    return true;
+}
+
+bool secu_store::store(const secu_key& key, const nr_security_context& ctx, uint32_t now) {
+    // a second round covers losing the slot to a concurrent store of the same key
+    for (int round = 0; round < 2; ++round) {
+        uint64_t meta = 0;
+        if (resolve(this, key, &meta)) {
+            auto*               s = shards[meta_shard(meta)].get();
+            const write_section w(s);
+            auto                e = s->entry(meta_index(meta));
+            if (alive(e, meta)) {
+                pack(ctx, now, &e);
+                s->set_entry(meta_index(meta), e);
+                return true;
+            }
+            // recycled by age(), the stale slot is replaced below
+        }
+
+        const auto hash = hash_of(key.kind, key.value);
+        const auto home = shard_of(this, hash);
+        auto*      s    = shards[home].get();
+        uint32_t   index;
+        uint16_t   gen;
+        {
+            const write_section w(s);
+            if (s->free_entries.empty()) return false;
+            index = s->free_entries.back();
+            s->free_entries.pop_back();
+            auto e         = s->entry(index);
+            e.flags        = flag_in_use;
+            e.pending_nksi = 0;
+            pack(ctx, now, &e);
+            s->set_entry(index, e);
+            gen = e.gen;
+            s->used_entries.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (link(this, key, make_meta(key.kind, gen, home, index), meta)) return true;
+
+        // give the entry back before trying again
+        const write_section w(s);
+        s->recycle(index);
+    }
+    return false;
+}
+
+bool secu_store::alias(const secu_key& existing, const secu_key& added) {
+    uint64_t   meta  = 0;
+    secu_entry entry = {};
+    if (!resolve(this, existing, &meta) || !read(this, meta, &entry)) return false;
+
+    uint64_t stale = 0;
+    if (resolve(this, added, &stale) && stale == meta) return true;
+    return link(this, added, meta, stale);
+}
+
+bool secu_store::update(const secu_key& key, const nmm_message_t& msg, uint32_t now) {
+    uint64_t meta = 0;
+    if (!resolve(this, key, &meta)) return false;
+
+    auto*               s = shards[meta_shard(meta)].get();
+    const write_section w(s);
+    auto                e = s->entry(meta_index(meta));
+    if (!alive(e, meta)) return false;
+
+    e.last_seen = now;
+    if (msg.authentication_request) {
+        // a new native key set is on its way, the current one stays in use until the SMC
+        e.pending_nksi =
+            uint8_t(flag_pending | (msg.authentication_request->nksi & flag_nksi));
+    } else if (msg.security_mode_command) {
+        // 9.11.3.34 selected NAS security algorithms, and COUNTs restart with the new
+        // context; the SMC names the key set it takes into use, pending or current
+        const auto& smc = *msg.security_mode_command;
+        e.algorithms    = smc.selected_security_algo;
+        e.flags         = uint8_t((e.flags & flag_in_use) | (smc.nksi & flag_nksi));
+        e.pending_nksi  = 0;
+        e.ul_count      = 0;
+        e.dl_count      = 0;
+    } else if (msg.security_mode_complete) {
+        e.flags |= flag_activated;
+    }
+    s->set_entry(meta_index(meta), e);
+    return true;
+}
+
+uint32_t secu_store::age(uint32_t now, uint32_t idle) {
+    uint32_t dropped = 0;
+    for (auto& s : shards) {
+        const write_section w(s.get());
+        for (uint32_t i = 0; i < s->entry_count; ++i) {
+            const auto e = s->entry(i);
+            if (!(e.flags & flag_in_use) || now - e.last_seen < idle) continue;
+            s->recycle(i);
+            ++dropped;
+        }
+    }
+
+    // keys whose entry is gone: found lock free, an entry once dropped never comes back
+    // under the same generation, then erased if the slot did not change meanwhile
+    std::vector< secu_slot > stale;
+    for (auto& s : shards) {
+        stale.clear();
+        for (uint32_t i = 0; i < s->slot_count; ++i) {
+            secu_slot slot = {};
+            s->optimistic([&] {
+                slot = s->slot(i);
+                return true;
+            });
+            secu_entry entry = {};
+            if (slot.meta != 0 && !read(this, slot.meta, &entry)) stale.push_back(slot);
+        }
+        if (stale.empty()) continue;
+
+        const write_section w(s.get());
+        for (const auto& slot : stale) {
+            const auto kind = meta_kind(slot.meta);
+            const auto i    = s->probe(kind, slot.value, hash_of(kind, slot.value));
+            if (i >= 0 && s->slot(uint32_t(i)).meta == slot.meta) s->erase(uint32_t(i));
+        }
+    }
+    return dropped;
+}
+
+uint32_t secu_store::size() const {
+    uint32_t n = 0;
+    for (const auto& s : shards) n += s->used_entries.load(std::memory_order_relaxed);
+    return n;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct nr_security_context;
+struct nmm_message_t;
+struct guti_nmid_t;
+struct s_tmsi_nmid_t;
+struct suci_nmid_t;
+
+namespace secu_key_kind {
+inline extern const uint8_t guti           = 1; // 5G-GUTI
+inline extern const uint8_t s_tmsi         = 2; // 5G-S-TMSI
+inline extern const uint8_t suci           = 3; // SUCI
+inline extern const uint8_t ran_ue_ngap_id = 4; // RAN UE NGAP ID, scoped by gNB
+} // namespace secu_key_kind
+
+// identity a security context can be looked up by, several keys may alias one context
+struct secu_key {
+    uint8_t  kind  = 0;
+    uint64_t value = 0;
+};
+
+secu_key guti_key(const guti_nmid_t& guti);
+secu_key s_tmsi_key(const s_tmsi_nmid_t& stmsi);
+secu_key suci_key(const suci_nmid_t& suci);
+secu_key ran_ue_ngap_key(uint32_t ran_ue_ngap_id, uint32_t gnb_id = 0);
+
+// what the store keeps of a nr_security_context, 84 bytes per UE
+struct secu_entry {
+    uint8_t  cyphering_key[16] = {};
+    uint8_t  integrity_key[16] = {};
+    uint8_t  kausf[32]         = {};
+    uint32_t ul_count          = 0; // 24 bits NAS COUNT
+    uint32_t dl_count          = 0;
+    uint32_t last_seen         = 0; // caller clock, seconds
+    uint16_t gen               = 0; // bumped when the entry is recycled
+    uint8_t  algorithms        = 0; // 9.11.3.34 ciphering << 4 | integrity
+    uint8_t  flags             = 0; // ngKSI 1-4, activated 5, COUNTs seen 6-7, in use 8
+    uint8_t  pending_nksi      = 0; // ngKSI awaiting its SMC bits 1-4, bit 8 when set
+};
+
+/* Per-UE security contexts for decoding captures with many UEs.
+ * Keys hash onto shards; each shard has a fixed open-addressing index and an entry pool
+ * sized at construction so nothing ever moves under a reader. Lookups take no lock: they
+ * copy what they need word by word through relaxed atomics and validate it against the
+ * shard sequence counter, retrying if a writer got in between. Writers serialize on the
+ * shard mutex and hold one at a time. An entry recycled so often that its generation
+ * would wrap is retired, so a stale key never resolves to a later owner. */
+struct secu_store {
+    explicit secu_store(uint32_t capacity, uint32_t shards = 64);
+    ~secu_store();
+
+    secu_store(const secu_store&) = delete;
+    secu_store& operator=(const secu_store&) = delete;
+
+    // copies the context known under key into ctx, hot path, never blocks
+    bool find(const secu_key& key, nr_security_context* ctx) const;
+
+    // creates or overwrites the context under key, false when the store is full
+    bool store(const secu_key& key, const nr_security_context& ctx, uint32_t now);
+
+    // makes added resolve to the same context as existing, e.g. the 5G-GUTI assigned to a
+    // UE that registered with a SUCI
+    bool alias(const secu_key& existing, const secu_key& added);
+
+    // follows Authentication Request, Security Mode Command and Security Mode Complete,
+    // other messages only refresh the idle timer
+    bool update(const secu_key& key, const nmm_message_t& msg, uint32_t now);
+
+    // drops contexts untouched for idle seconds and keys pointing at them, returns the
+    // number of contexts dropped
+    uint32_t age(uint32_t now, uint32_t idle);
+
+    uint32_t size() const;
+
+    struct shard;
+    std::vector< std::unique_ptr< shard > > shards;
+};
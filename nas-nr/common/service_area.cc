@@ -0,0 +1,80 @@
+#include "service_area.hh"
+
+#include "messages.hh"
+
+namespace {
+uint32_t tac_of(const tac_t& tac) {
+    return uint32_t(tac.v[0]) << 16u | uint32_t(tac.v[1]) << 8u | tac.v[2];
+}
+
+bool same_areas(const tai_set& a, const tai_set& b) {
+    if (a.n != b.n) return false;
+    for (int i = 0; i < a.n; ++i) {
+        if (a.ranges[i].low != b.ranges[i].low || a.ranges[i].high != b.ranges[i].high)
+            return false;
+    }
+    return true;
+}
+} // namespace
+
+bool service_area_restriction::update(const service_area_list_t& list) {
+    service_area_restriction next;
+    next.present = true;
+
+    for (const auto& p : list.partial) {
+        if (p.l_00) {
+            next.non_allowed = p.l_00->header.allowed_type;
+            for (const auto& tac : p.l_00->tacs) {
+                const auto k = tai_key(p.l_00->mccmnc, tac_of(tac));
+                next.areas.add(k, k);
+            }
+        }
+        if (p.l_01) {
+            // number + 1 consecutive TACs
+            next.non_allowed = p.l_01->header.allowed_type;
+            const auto k     = tai_key(p.l_01->mccmnc, tac_of(p.l_01->tac));
+            next.areas.add(k, k + p.l_01->header.number);
+        }
+        if (p.l_10) {
+            next.non_allowed = p.l_10->header.allowed_type;
+            for (const auto& a : p.l_10->value) {
+                const auto k = tai_key(a.mccmnc, tac_of(a.tac));
+                next.areas.add(k, k);
+            }
+        }
+        if (p.l_11) {
+            next.non_allowed = p.l_11->header.allowed_type;
+            next.areas.add(tai_key(p.l_11->mccmnc, 0), tai_key(p.l_11->mccmnc, 0xffffffu));
+        }
+    }
+
+    const auto changed = !present || next.non_allowed != non_allowed ||
+                         !same_areas(next.areas, areas);
+    *this = next;
+    return changed;
+}
+
+bool service_area_restriction::update(const nmm_message_t& msg) {
+    if (msg.registration_accept) {
+        if (const auto* list = lazy_ie(msg.registration_accept->service_area_list))
+            return update(*list);
+        // TS 24.501 5.5.1.2.4: without the IE every TA is allowed, the old list is gone
+        *this = {};
+        return true;
+    }
+    if (msg.configuration_update_command) {
+        // absent here leaves the restriction as it was
+        const auto* list = lazy_ie(msg.configuration_update_command->service_areas);
+        return list ? update(*list) : false;
+    }
+    return false;
+}
+
+bool service_area_restriction::allowed(uint64_t tai) const {
+    if (!present) return true;
+    return areas.contains(tai) != non_allowed;
+}
+
+bool service_area_restriction::allowed(const nr_tracking_area_id_t& tai) const {
+    return allowed(tai_key(tai));
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+#include "tai_set.hh"
+
+struct nmm_message_t;
+
+/* 9.11.3.49 Service area list folded into one tai_set of allowed or of non-allowed
+ * areas, as TS 23.501 5.3.4.1 lists either one or the other. A type 11 partial list,
+ * every TAI of a PLMN, is the whole TAC range of that PLMN. */
+struct service_area_restriction {
+    bool    present     = false; // a list was received, unrestricted until then
+    bool    non_allowed = false; // areas are non-allowed rather than allowed
+    tai_set areas       = {};
+
+    // replaces the restriction, false when the new list restricts exactly the same TAIs
+    bool update(const service_area_list_t& list);
+
+    // the service area list of a registration accept or configuration update command,
+    // false when the message has none or it changed nothing; a registration accept
+    // without one lifts the restriction
+    bool update(const nmm_message_t& msg);
+
+    bool allowed(uint64_t tai) const; // tai_key()
+    bool allowed(const nr_tracking_area_id_t& tai) const;
+};
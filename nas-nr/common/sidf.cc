@@ -0,0 +1,309 @@
+#include "sidf.hh"
+
+#include <cstring>
+#include <thread>
+
+#include <gmp.h>
+#include <nettle/aes.h>
+#include <nettle/curve25519.h>
+#include <nettle/ctr.h>
+#include <nettle/ecc-curve.h>
+#include <nettle/ecc.h>
+#include <nettle/hmac.h>
+
+extern "C" {
+#include "sha256_mb.h"
+}
+
+namespace {
+const int key_length = 32;
+const int mac_length = 8; // HMAC-SHA-256-64
+const int kdf_length = 64; // encryption key 16, ICB 16, MAC key 32
+const int kdf_blocks = 2;  // Z, counter and a public key of 32 or 33 octets, padded
+
+// per SUCI of a batch pass, two KDF counters each fill the eight lanes
+const int pass = SHA256_MB_LANES / 2;
+
+// secp256r1 field prime and b, x^3 - 3x + b
+const char* const p256_p =
+    "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff";
+const char* const p256_b =
+    "5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b";
+
+// the ephemeral public key, ciphertext and MAC tag of a scheme output
+struct ecies_t {
+    const uint8_t* public_key        = nullptr;
+    int            public_key_length = 0;
+    const uint8_t* ciphertext        = nullptr;
+    int            ciphertext_length = 0;
+    const uint8_t* mac               = nullptr;
+};
+
+bool split(const octet_t& output, int public_key_length, ecies_t* ret) {
+    const auto l = int(output.size()) - public_key_length - mac_length;
+    // the MSIN is 10 digits at most
+    if (l < 1 || l > 5) return false;
+    ret->public_key        = output.data();
+    ret->public_key_length = public_key_length;
+    ret->ciphertext        = output.data() + public_key_length;
+    ret->ciphertext_length = l;
+    ret->mac               = ret->ciphertext + l;
+    return true;
+}
+
+// MSIN digits as coded in the null scheme or the plaintext, digit 1 low, 0xf filler last
+bool msin_of(const uint8_t* p, int length, supi_imsi_t* ret) {
+    ret->msin_length = 0;
+    for (auto i = 0; i < length; ++i) {
+        const uint8_t d[2] = {uint8_t(p[i] & 0x0fu), uint8_t(p[i] >> 4u)};
+        for (auto k = 0; k < 2; ++k) {
+            if (d[k] == 0x0f && i == length - 1 && k == 1) break;
+            if (d[k] > 9 || ret->msin_length == sizeof(ret->msin)) return false;
+            ret->msin[ret->msin_length++] = d[k];
+        }
+    }
+    return ret->msin_length > 0;
+}
+
+// scratch of one thread, set up once for all the SUCIs it deconceals
+struct scratch_t {
+    mpz_t            x, y, t, p, b, e;
+    struct ecc_point q, r;
+
+    scratch_t() {
+        const auto* c = nettle_get_secp_256r1();
+        mpz_inits(x, y, t, p, b, e, nullptr);
+        mpz_set_str(p, p256_p, 16);
+        mpz_set_str(b, p256_b, 16);
+        mpz_add_ui(e, p, 1);
+        mpz_fdiv_q_2exp(e, e, 2); // p = 3 mod 4, a root is a power (p + 1) / 4
+        ecc_point_init(&q, c);
+        ecc_point_init(&r, c);
+    }
+    ~scratch_t() {
+        ecc_point_clear(&q);
+        ecc_point_clear(&r);
+        mpz_clears(x, y, t, p, b, e, nullptr);
+    }
+    scratch_t(const scratch_t&) = delete;
+    scratch_t& operator=(const scratch_t&) = delete;
+
+    // compressed point, SEC 1 2.3.4, false when it is not on the curve
+    bool decompress(const uint8_t* k) {
+        if (k[0] != 0x02 && k[0] != 0x03) return false;
+        mpz_import(x, key_length, 1, 1, 1, 0, k + 1);
+        if (mpz_cmp(x, p) >= 0) return false;
+
+        mpz_powm_ui(t, x, 3, p);
+        mpz_submul_ui(t, x, 3);
+        mpz_add(t, t, b);
+        mpz_mod(t, t, p);
+        mpz_powm(y, t, e, p);
+        if (mpz_odd_p(y) != (k[0] & 1)) mpz_sub(y, p, y);
+        return ecc_point_set(&q, x, y) != 0;
+    }
+};
+
+void x_of(mpz_t x, uint8_t* z) {
+    size_t  l = 0;
+    uint8_t v[key_length];
+    mpz_export(v, &l, 1, 1, 1, 0, x);
+    std::memset(z, 0, key_length);
+    std::memcpy(z + key_length - l, v, l);
+}
+
+// one block stream of the X9.63 KDF, Z, counter and shared info padded to two blocks
+void kdf_input(const uint8_t* z, uint32_t counter, const ecies_t& e, uint8_t* block) {
+    std::memset(block, 0, kdf_blocks * SHA256_BLOCK_SIZE);
+    std::memcpy(block, z, key_length);
+    block[32] = uint8_t(counter >> 24u);
+    block[33] = uint8_t(counter >> 16u);
+    block[34] = uint8_t(counter >> 8u);
+    block[35] = uint8_t(counter);
+    std::memcpy(block + 36, e.public_key, size_t(e.public_key_length));
+
+    const auto l    = 36 + e.public_key_length;
+    const auto bits = uint64_t(l) * 8;
+    block[l]        = 0x80;
+    for (auto i = 0; i < 8; ++i)
+        block[kdf_blocks * SHA256_BLOCK_SIZE - 1 - i] = uint8_t(bits >> (8u * i));
+}
+
+// MAC tag check, then the MSIN from the plaintext
+uint8_t unseal(const ecies_t& e, const uint8_t* keys, supi_imsi_t* ret) {
+    uint8_t         mac[mac_length];
+    hmac_sha256_ctx h;
+    hmac_sha256_set_key(&h, 32, keys + 32);
+    hmac_sha256_update(&h, size_t(e.ciphertext_length), e.ciphertext);
+    hmac_sha256_digest(&h, mac_length, mac);
+
+    uint8_t diff = 0;
+    for (auto i = 0; i < mac_length; ++i) diff |= uint8_t(mac[i] ^ e.mac[i]);
+    if (diff != 0) return suci_status::mac_failure;
+
+    aes128_ctx aes;
+    uint8_t    icb[AES_BLOCK_SIZE];
+    uint8_t    msin[5];
+    aes128_set_encrypt_key(&aes, keys);
+    std::memcpy(icb, keys + 16, sizeof(icb));
+    ctr_crypt(&aes, reinterpret_cast< nettle_cipher_func* >(aes128_encrypt),
+              AES_BLOCK_SIZE, icb, size_t(e.ciphertext_length), msin, e.ciphertext);
+    return msin_of(msin, e.ciphertext_length, ret) ? suci_status::ok
+                                                   : suci_status::malformed;
+}
+} // namespace
+
+struct suci_sidf::key_t {
+    uint8_t           scheme             = 0;
+    uint8_t           x25519[key_length] = {};
+    struct ecc_scalar p256;
+
+    key_t() { ecc_scalar_init(&p256, nettle_get_secp_256r1()); }
+    ~key_t() { ecc_scalar_clear(&p256); }
+    key_t(const key_t&) = delete;
+    key_t& operator=(const key_t&) = delete;
+};
+
+namespace {
+struct batch_t {
+    const std::vector< std::unique_ptr< suci_sidf::key_t > >* keys;
+    const suci_imsi_nmid_t* const*                            sucis;
+    supi_imsi_t*                                              ret;
+};
+
+// status of the SUCI, the shared secret in z when it is ok so far
+uint8_t agree(const batch_t& b, int i, scratch_t* s, ecies_t* e, uint8_t* z) {
+    namespace p = suci_protection_scheme;
+
+    const auto& suci = *b.sucis[i];
+    auto*       ret  = &b.ret[i];
+    ret->plmn        = suci.mccmnc;
+    ret->msin_length = 0;
+    if (suci.protection_scheme_id == p::null_scheme) {
+        if (!suci.msin) return suci_status::malformed;
+        for (auto d : *suci.msin) {
+            if (d == 0x0f) break;
+            if (d > 9 || ret->msin_length == sizeof(ret->msin))
+                return suci_status::malformed;
+            ret->msin[ret->msin_length++] = d;
+        }
+        return suci_status::ok;
+    }
+    const auto scheme = suci.protection_scheme_id;
+    if (scheme != p::profile_a && scheme != p::profile_b)
+        return suci_status::unknown_scheme;
+
+    const auto& k = (*b.keys)[(scheme - 1) * 256 + suci.home_network_public_key_id];
+    if (!k) return suci_status::unknown_key;
+
+    const auto a = scheme == p::profile_a;
+    if (!suci.scheme_output || !split(*suci.scheme_output, a ? 32 : 33, e))
+        return suci_status::malformed;
+
+    if (a) {
+        curve25519_mul(z, k->x25519, e->public_key);
+        uint8_t any = 0;
+        for (auto j = 0; j < key_length; ++j) any |= z[j];
+        return any ? suci_status::ok : suci_status::bad_public_key; // small order point
+    }
+    if (!s->decompress(e->public_key)) return suci_status::bad_public_key;
+    ecc_point_mul(&s->r, &k->p256, &s->q);
+    ecc_point_get(&s->r, s->x, s->y);
+    x_of(s->x, z);
+    return suci_status::ok;
+}
+
+// SUCIs from first to last, pass by pass
+void run(const batch_t& b, int first, int last) {
+    scratch_t s;
+
+    ecies_t        e[pass];
+    uint8_t        z[pass][key_length];
+    uint8_t        blocks[2 * pass][kdf_blocks * SHA256_BLOCK_SIZE];
+    sha256_state_t states[2 * pass];
+    const uint8_t* lanes[2 * pass];
+    unsigned       nblocks[2 * pass];
+    int            todo[pass];
+
+    for (auto i = first; i < last; i += pass) {
+        const auto end = i + pass < last ? i + pass : last;
+        auto       n   = 0;
+        for (auto j = i; j < end; ++j) {
+            b.ret[j].status = agree(b, j, &s, &e[n], z[n]);
+            if (b.ret[j].status != suci_status::ok) continue;
+            if (b.sucis[j]->protection_scheme_id == suci_protection_scheme::null_scheme)
+                continue;
+
+            for (auto c = 0; c < 2; ++c) {
+                const auto lane = 2 * n + c;
+                kdf_input(z[n], uint32_t(c + 1), e[n], blocks[lane]);
+                sha256_state_init(&states[lane]);
+                lanes[lane]   = blocks[lane];
+                nblocks[lane] = kdf_blocks;
+            }
+            todo[n++] = j;
+        }
+        if (n == 0) continue;
+
+        sha256_mb_compress(states, lanes, nblocks, unsigned(2 * n));
+        for (auto k = 0; k < n; ++k) {
+            uint8_t keys[kdf_length];
+            sha256_state_digest(&states[2 * k], keys, SHA256_DIGEST_SIZE);
+            sha256_state_digest(&states[2 * k + 1], keys + 32, SHA256_DIGEST_SIZE);
+            b.ret[todo[k]].status = unseal(e[k], keys, &b.ret[todo[k]]);
+        }
+    }
+}
+} // namespace
+
+suci_sidf::suci_sidf() : keys(2 * 256) {}
+
+suci_sidf::~suci_sidf() = default;
+
+bool suci_sidf::add_key(uint8_t        protection_scheme,
+                        uint8_t        id,
+                        const uint8_t* private_key) {
+    namespace p = suci_protection_scheme;
+    if (protection_scheme != p::profile_a && protection_scheme != p::profile_b)
+        return false;
+
+    std::unique_ptr< key_t > k(new key_t);
+    k->scheme = protection_scheme;
+    if (protection_scheme == p::profile_a) {
+        std::memcpy(k->x25519, private_key, key_length);
+    } else {
+        mpz_t v;
+        mpz_init(v);
+        mpz_import(v, key_length, 1, 1, 1, 0, private_key);
+        const auto valid = ecc_scalar_set(&k->p256, v) != 0;
+        mpz_clear(v);
+        if (!valid) return false;
+    }
+    keys[(protection_scheme - 1) * 256 + id] = std::move(k);
+    return true;
+}
+
+uint8_t suci_sidf::deconceal(const suci_imsi_nmid_t& suci, supi_imsi_t* ret) const {
+    const suci_imsi_nmid_t* p = &suci;
+    deconceal(&p, 1, ret);
+    return ret->status;
+}
+
+void suci_sidf::deconceal(const suci_imsi_nmid_t* const* sucis,
+                          int                            n,
+                          supi_imsi_t*                   ret,
+                          int                            threads) const {
+    const batch_t b = {&keys, sucis, ret};
+    if (threads < 1) threads = 1;
+    // a thread below a few passes costs more than it saves
+    if (threads > n / (4 * pass)) threads = n / (4 * pass) > 0 ? n / (4 * pass) : 1;
+
+    std::vector< std::thread > workers;
+    const auto                 chunk = (n + threads - 1) / threads;
+    for (auto t = 1; t < threads; ++t) {
+        const auto first = t * chunk, last = first + chunk < n ? first + chunk : n;
+        if (first < last) workers.emplace_back(run, b, first, last);
+    }
+    run(b, 0, chunk < n ? chunk : n);
+    for (auto& w : workers) w.join();
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ies.hh"
+
+// 9.11.3.4 protection scheme identifier, TS 33.501 C.1
+namespace suci_protection_scheme {
+inline extern const uint8_t null_scheme = 0;
+inline extern const uint8_t profile_a   = 1; // ECIES, X25519
+inline extern const uint8_t profile_b   = 2; // ECIES, secp256r1 compressed points
+} // namespace suci_protection_scheme
+
+namespace suci_status {
+inline extern const uint8_t ok              = 0;
+inline extern const uint8_t malformed       = 1; // scheme output or MSIN not as coded
+inline extern const uint8_t unknown_key     = 2; // no private key for scheme and id
+inline extern const uint8_t bad_public_key  = 3; // ephemeral key not on the curve
+inline extern const uint8_t mac_failure     = 4; // MAC tag differs
+inline extern const uint8_t unknown_scheme  = 5;
+} // namespace suci_status
+
+// SUPI of format IMSI a SUCI conceals, the MNC digit count is not known from mcc_mnc_t
+struct supi_imsi_t {
+    mcc_mnc_t plmn        = {};
+    uint8_t   msin[10]    = {}; // digits 0-9
+    uint8_t   msin_length = 0;
+    uint8_t   status      = 0; // suci_status
+};
+
+/* Deconceals SUCIs of SUPI format IMSI as a SIDF would, TS 33.501 6.12.2 and Annex C.3:
+ * ECDH of the home network private key with the ephemeral public key of the scheme
+ * output, ANSI X9.63 KDF with SHA-256 into the AES-128-CTR key and ICB and the
+ * HMAC-SHA-256-64 key, MAC tag check over the ciphertext, then decryption of the MSIN.
+ * The null scheme needs no key, its MSIN is copied.
+ *
+ * Keys are set up once, profile B scalars included, so deconcealing only multiplies. The
+ * batch call runs the two KDF blocks of four SUCIs at a time through the multi-buffer
+ * SHA-256 kernel and splits the SUCIs over threads, each with its own scratch numbers;
+ * a SUCI fails alone, its status says why. Const calls may run concurrently. */
+struct suci_sidf {
+    suci_sidf();
+    ~suci_sidf();
+
+    suci_sidf(const suci_sidf&) = delete;
+    suci_sidf& operator=(const suci_sidf&) = delete;
+
+    // 32 octet private key of the home network public key identifier, X25519 scalar for
+    // profile A, big endian for profile B; false on another scheme or an invalid scalar
+    bool add_key(uint8_t protection_scheme, uint8_t id, const uint8_t* private_key);
+
+    uint8_t deconceal(const suci_imsi_nmid_t& suci, supi_imsi_t* ret) const;
+
+    // ret holds n results, threads of 0 or 1 deconceal on the calling thread
+    void deconceal(const suci_imsi_nmid_t* const* sucis,
+                   int                            n,
+                   supi_imsi_t*                   ret,
+                   int                            threads = 1) const;
+
+    struct key_t;
+    std::vector< std::unique_ptr< key_t > > keys; // by scheme - 1, then id
+};
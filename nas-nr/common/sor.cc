@@ -0,0 +1,161 @@
+#include "sor.hh"
+
+#include <algorithm>
+
+#include <nettle/hmac.h>
+
+#include "context.hh"
+
+namespace {
+const int mac_length   = 16;
+const int kausf_length = 32;
+
+namespace fc {
+const uint8_t sor_mac_iausf = 0x77;
+const uint8_t sor_mac_iue   = 0x78;
+} // namespace fc
+
+// P and L of TS 33.220 B.2, the length in two octets
+void hmac_param(hmac_sha256_ctx* ctx, const uint8_t* p, int length) {
+    const uint8_t l[2] = {uint8_t(length >> 8), uint8_t(length)};
+    hmac_sha256_update(ctx, size_t(length), p);
+    hmac_sha256_update(ctx, 2, l);
+}
+
+// the 128 least significant bits of the KDF output against mac, in constant time
+bool same_mac(hmac_sha256_ctx* ctx, const uint8_t* mac) {
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    hmac_sha256_digest(ctx, sizeof(digest), digest);
+
+    uint8_t diff = 0;
+    for (auto i = 0; i < mac_length; ++i)
+        diff |= uint8_t(digest[SHA256_DIGEST_SIZE - mac_length + i] ^ mac[i]);
+    return diff == 0;
+}
+
+void start(hmac_sha256_ctx* ctx, const uint8_t* kausf, uint8_t fc) {
+    hmac_sha256_set_key(ctx, kausf_length, kausf);
+    hmac_sha256_update(ctx, 1, &fc);
+}
+
+bool any_key(const uint8_t* kausf) {
+    uint8_t any = 0;
+    for (auto i = 0; i < kausf_length; ++i) any |= kausf[i];
+    return any != 0;
+}
+} // namespace
+
+uint32_t sor_plmn_key(const mcc_mnc_t& plmn) {
+    return uint32_t(plmn.mcc) << 10u | (plmn.mnc & 0x3ffu);
+}
+
+uint32_t sor_plmn_key(const uint8_t* p) {
+    const uint32_t mcc  = (p[0] & 0x0fu) * 100 + (p[0] >> 4u) * 10 + (p[1] & 0x0fu);
+    const uint32_t mnc3 = p[1] >> 4u;
+    uint32_t       mnc  = (p[2] & 0x0fu) * 10 + (p[2] >> 4u);
+    if (mnc3 != 0xf) mnc = mnc * 10 + mnc3;
+    return mcc << 10u | (mnc & 0x3ffu);
+}
+
+sor_plmn_index::sor_plmn_index(const sor_transparent_container_t& sor) {
+    if (!sor.access_technology) return;
+    for (const auto& v : *sor.access_technology) {
+        if (n == capacity) {
+            truncated = true;
+            break;
+        }
+        auto& e             = entries[n];
+        e.plmn              = sor_plmn_key(v.id);
+        e.access_technology = v.access_technology_id;
+        e.priority          = n++;
+    }
+    std::stable_sort(entries, entries + n, [](const entry_t& a, const entry_t& b) {
+        return a.plmn < b.plmn;
+    });
+}
+
+const sor_plmn_index::entry_t* sor_plmn_index::first(uint32_t plmn) const {
+    return std::lower_bound(entries, entries + n, plmn, [](const entry_t& e, uint32_t k) {
+        return e.plmn < k;
+    });
+}
+
+bool sor_plmn_index::find(const mcc_mnc_t& plmn, entry_t* ret) const {
+    const auto  k  = sor_plmn_key(plmn);
+    const auto* it = first(k);
+    if (it == entries + n || it->plmn != k) return false;
+    *ret = *it;
+    return true;
+}
+
+int sor_plmn_index::priority(const mcc_mnc_t& plmn, uint16_t access_technology) const {
+    const auto k = sor_plmn_key(plmn);
+    for (const auto* it = first(k); it != entries + n && it->plmn == k; ++it) {
+        if (it->access_technology & access_technology) return it->priority;
+    }
+    return -1;
+}
+
+bool sor_verify_mac_iausf(const uint8_t* contents, int length, const uint8_t* kausf) {
+    // SOR header, SOR-MAC-IAUSF, CounterSOR, then the list if any
+    if (!contents || !kausf || length < 1 + mac_length + 2) return false;
+    if (contents[0] & 0x01u) return false; // SOR data type 1, from the UE
+
+    hmac_sha256_ctx ctx;
+    start(&ctx, kausf, fc::sor_mac_iausf);
+    hmac_param(&ctx, contents, 1);
+    hmac_param(&ctx, contents + 1 + mac_length, 2);
+    const auto list = length - 1 - mac_length - 2;
+    if (list > 0) hmac_param(&ctx, contents + 1 + mac_length + 2, list);
+    return same_mac(&ctx, contents + 1);
+}
+
+bool sor_verify_mac_iausf(const sor_transparent_container_t& sor,
+                          const nr_security_context&         ctx) {
+    if (sor.header.sor_data_type != 0 || !any_key(ctx.kausf)) return false;
+
+    const uint8_t counter[2] = {uint8_t(sor.counter >> 8), uint8_t(sor.counter)};
+
+    hmac_sha256_ctx c;
+    start(&c, ctx.kausf, fc::sor_mac_iausf);
+    // the octet as received, spare bits included
+    hmac_param(&c, &sor.header_octet, 1);
+    hmac_param(&c, counter, 2);
+
+    // the list as it was coded, hashed entry by entry
+    int list = 0;
+    if (sor.access_technology) {
+        for (const auto& v : *sor.access_technology) {
+            const uint8_t t[2] = {uint8_t(v.access_technology_id >> 8),
+                                  uint8_t(v.access_technology_id)};
+            hmac_sha256_update(&c, sizeof(v.id), v.id);
+            hmac_sha256_update(&c, 2, t);
+            list += int(sizeof(v.id)) + 2;
+        }
+    } else if (sor.packet && !sor.packet->empty()) {
+        list = int(sor.packet->size());
+        hmac_sha256_update(&c, size_t(list), sor.packet->data());
+    }
+    if (list > 0) {
+        const uint8_t l[2] = {uint8_t(list >> 8), uint8_t(list)};
+        hmac_sha256_update(&c, 2, l);
+    }
+    return same_mac(&c, sor.maci);
+}
+
+bool sor_verify_mac_iue(const uint8_t* contents,
+                        int            length,
+                        uint16_t       counter,
+                        const uint8_t* kausf) {
+    if (!contents || !kausf || length < 1 + mac_length) return false;
+    if (!(contents[0] & 0x01u)) return false; // SOR data type 0, from the network
+
+    const uint8_t ack    = 0x01; // SoR Acknowledgement
+    const uint8_t c16[2] = {uint8_t(counter >> 8), uint8_t(counter)};
+
+    hmac_sha256_ctx ctx;
+    start(&ctx, kausf, fc::sor_mac_iue);
+    hmac_param(&ctx, &ack, 1);
+    hmac_param(&ctx, c16, 2);
+    return same_mac(&ctx, contents + 1);
+}
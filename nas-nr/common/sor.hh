@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+
+#include "ies.hh"
+
+struct nr_security_context;
+
+// TS 31.102 4.2.5 access technology identifier, coded as in the SOR list
+namespace sor_access_technology {
+inline extern const uint16_t utran          = 0x8000;
+inline extern const uint16_t e_utran        = 0x4000;
+inline extern const uint16_t e_utran_wb_s1  = 0x2000;
+inline extern const uint16_t e_utran_nb_s1  = 0x1000;
+inline extern const uint16_t ng_ran         = 0x0800;
+inline extern const uint16_t gsm            = 0x0080;
+inline extern const uint16_t gsm_compact    = 0x0040;
+inline extern const uint16_t cdma2000_hrpd  = 0x0020;
+inline extern const uint16_t cdma2000_1xrtt = 0x0010;
+} // namespace sor_access_technology
+
+/* The preferred PLMN/access technology list of a SOR transparent container, in a fixed
+ * array sorted by PLMN. The IE holds at most 16 entries (octets 23-102), so building and
+ * looking up never allocate; priority is the position in the list, 0 the most preferred.
+ * A PLMN may be listed again for other access technologies, its entries stay in order.
+ * The decoder keeps whatever list was sent, entries past capacity set truncated. */
+struct sor_plmn_index {
+    static const int capacity = 16;
+
+    struct entry_t {
+        uint32_t plmn              = 0; // sor_plmn_key()
+        uint16_t access_technology = 0; // sor_access_technology bits
+        uint8_t  priority          = 0;
+    };
+
+    sor_plmn_index() = default;
+    explicit sor_plmn_index(const sor_transparent_container_t& sor);
+
+    // the most preferred entry of plmn
+    bool find(const mcc_mnc_t& plmn, entry_t* ret) const;
+
+    // priority of plmn on any of access_technology, -1 when not preferred there
+    int priority(const mcc_mnc_t& plmn, uint16_t access_technology) const;
+
+    const entry_t* first(uint32_t plmn) const;
+
+    entry_t entries[capacity] = {};
+    uint8_t n                 = 0;
+    bool    truncated         = false; // the container listed more than capacity
+};
+
+uint32_t sor_plmn_key(const mcc_mnc_t& plmn);
+uint32_t sor_plmn_key(const uint8_t* plmn_id); // 3 octets as coded in 9.11.3.51
+
+/* SOR-MAC-IAUSF of a network to UE container, TS 33.501 A.17: HMAC-SHA-256 with KAUSF
+ * over FC 0x77, the SOR header, CounterSOR and the list when one is sent, of which the
+ * 128 least significant bits. Hashed in place from the IE contents or the decoded IE,
+ * nothing is allocated. False for a UE to network container, it has no CounterSOR. */
+bool sor_verify_mac_iausf(const uint8_t* contents, int length, const uint8_t* kausf);
+bool sor_verify_mac_iausf(const sor_transparent_container_t& sor,
+                          const nr_security_context&         ctx);
+
+/* SOR-MAC-IUE of a UE to network acknowledgement, TS 33.501 A.18, over FC 0x78, the SOR
+ * acknowledgement and the CounterSOR of the container it acknowledges. */
+bool sor_verify_mac_iue(const uint8_t* contents,
+                        int            length,
+                        uint16_t       counter,
+                        const uint8_t* kausf);
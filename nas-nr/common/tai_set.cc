@@ -0,0 +1,165 @@
+#include "tai_set.hh"
+
+#include "dissector.hh"
+
+namespace {
+uint32_t tac_of(const uint8_t* p) {
+    return uint32_t(p[0]) << 16u | uint32_t(p[1]) << 8u | p[2];
+}
+
+mcc_mnc_t plmn_of(const uint8_t* p) {
+    mcc_mnc_t ret = {};
+    die_mcc_mnc(dissector{nullptr, p, 3, 0, 3}, nullptr, &ret);
+    return ret;
+}
+
+bool same_plmn(uint64_t a, uint64_t b) {
+    return a >> 24u == b >> 24u;
+}
+} // namespace
+
+uint64_t tai_key(const mcc_mnc_t& plmn, uint32_t tac) {
+    return uint64_t(plmn.mcc) << 34u | uint64_t(plmn.mnc & 0x3ffu) << 24u |
+           (tac & 0xffffffu);
+}
+
+uint64_t tai_key(const nr_tracking_area_id_t& tai) {
+    return tai_key(tai.mccmnc, tac_of(tai.tac));
+}
+
+tai_set::tai_set(const nr_tracking_area_id_list_t& list) {
+    for (const auto& p : list.partials) {
+        if (p.l00) {
+            for (const auto& tac : p.l00->taces) {
+                const auto k = tai_key(p.l00->mccmnc, tac_of(tac.v));
+                add(k, k);
+            }
+        }
+        if (p.l01) {
+            const auto k = tai_key(p.l01->mccmnc, tac_of(p.l01->tac));
+            add(k, k + p.l01->number);
+        }
+        if (p.l10) {
+            for (const auto& tai : p.l10->ids) add(tai_key(tai), tai_key(tai));
+        }
+    }
+}
+
+// Figure 9.11.3.9.2 - 9.11.3.9.4, walked in place without building the partial lists
+bool tai_set::parse(const uint8_t* data, int length) {
+    int i = 0;
+    while (i < length) {
+        const auto type   = (data[i] >> 5u) & 0x03u;
+        const auto number = int(data[i] & 0x1fu) + 1; // encoded minus one
+        const auto* p     = data + i + 1;
+
+        int size = 0;
+        if (type == 0) size = 3 + 3 * number;
+        else if (type == 1) size = 3 + 3;
+        else if (type == 2) size = 6 * number;
+        else return false; // reserved, length unknown
+        if (i + 1 + size > length) return false;
+
+        if (type == 0) {
+            const auto plmn = plmn_of(p);
+            for (auto k = 0; k < number; ++k) {
+                const auto key = tai_key(plmn, tac_of(p + 3 + 3 * k));
+                add(key, key);
+            }
+        } else if (type == 1) {
+            const auto key = tai_key(plmn_of(p), tac_of(p + 3));
+            add(key, key + uint32_t(number - 1));
+        } else {
+            for (auto k = 0; k < number; ++k) {
+                const auto key = tai_key(plmn_of(p + 6 * k), tac_of(p + 6 * k + 3));
+                add(key, key);
+            }
+        }
+        i += 1 + size;
+    }
+    return true;
+}
+
+void tai_set::add(uint64_t low, uint64_t high) {
+    // consecutive TACs stop at the last TAC of the PLMN
+    if (!same_plmn(low, high)) high = low | 0xffffffu;
+
+    // first range overlapping [low, high] or adjacent to it within the PLMN
+    auto before = [&](const range_t& r) {
+        return r.high < low && !(r.high + 1 == low && same_plmn(r.high, low));
+    };
+    auto joins = [&](const range_t& r) {
+        return r.low <= high || (r.low == high + 1 && same_plmn(r.low, high));
+    };
+    int i = 0;
+    while (i < n && before(ranges[i])) ++i;
+
+    int j = i;
+    for (; j < n && joins(ranges[j]); ++j) {
+        if (ranges[j].low < low) low = ranges[j].low;
+        if (ranges[j].high > high) high = ranges[j].high;
+    }
+
+    const int removed = j - i;
+    if (removed == 0 && n == capacity) {
+        overflow = true;
+        return;
+    }
+    const int shift = 1 - removed;
+    if (shift > 0)
+        for (int k = n - 1; k >= j; --k) ranges[k + shift] = ranges[k];
+    else if (shift < 0)
+        for (int k = j; k < n; ++k) ranges[k + shift] = ranges[k];
+    ranges[i] = {low, high};
+    n         = uint8_t(n + shift);
+}
+
+bool tai_set::contains(uint64_t key) const {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (ranges[mid].high < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < n && ranges[lo].low <= key;
+}
+
+bool tai_set::contains(const nr_tracking_area_id_t& tai) const {
+    return contains(tai_key(tai));
+}
+
+bool tai_set::intersects(const tai_set& other) const {
+    int i = 0, j = 0;
+    while (i < n && j < other.n) {
+        const auto& a = ranges[i];
+        const auto& b = other.ranges[j];
+        if (a.high < b.low) ++i;
+        else if (b.high < a.low) ++j;
+        else return true;
+    }
+    return false;
+}
+
+tai_set tai_set::intersection(const tai_set& other) const {
+    tai_set ret;
+    int     i = 0, j = 0;
+    while (i < n && j < other.n) {
+        const auto& a    = ranges[i];
+        const auto& b    = other.ranges[j];
+        const auto  low  = a.low > b.low ? a.low : b.low;
+        const auto  high = a.high < b.high ? a.high : b.high;
+        if (low <= high) {
+            if (ret.n < capacity) ret.ranges[ret.n++] = {low, high};
+            else ret.overflow = true;
+        }
+        if (a.high < b.high) ++i;
+        else ++j;
+    }
+    return ret;
+}
+
+uint64_t tai_set::size() const {
+    uint64_t ret = 0;
+    for (int i = 0; i < n; ++i) ret += ranges[i].high - ranges[i].low + 1;
+    return ret;
+}
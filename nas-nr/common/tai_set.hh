@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+#include "ies.hh"
+
+// 9.11.3.8 TAI packed as mcc << 34 | mnc << 24 | tac, so TAIs of one PLMN sort together
+uint64_t tai_key(const mcc_mnc_t& plmn, uint32_t tac);
+uint64_t tai_key(const nr_tracking_area_id_t& tai);
+
+/* 9.11.3.9 5GS tracking area identity list as sorted, merged ranges of tai_key() values.
+ * A list holds at most 16 TAIs, so the ranges live inline and a lookup is a binary search
+ * over no more than 16 entries, with no allocation on the registration path. A type 01
+ * partial list always takes a single range. */
+struct tai_set {
+    static const int capacity = 16;
+
+    struct range_t {
+        uint64_t low  = 0; // inclusive, both in one PLMN
+        uint64_t high = 0;
+    };
+
+    tai_set() = default;
+    explicit tai_set(const nr_tracking_area_id_list_t& list);
+
+    // the contents of a 5GS tracking area identity list IE, false when malformed
+    bool parse(const uint8_t* data, int length);
+
+    void add(uint64_t low, uint64_t high);
+
+    bool     contains(uint64_t key) const;
+    bool     contains(const nr_tracking_area_id_t& tai) const;
+    bool     intersects(const tai_set& other) const;
+    tai_set  intersection(const tai_set& other) const;
+    uint64_t size() const; // number of TAIs
+    bool     empty() const { return n == 0; }
+
+    range_t ranges[capacity] = {};
+    uint8_t n                = 0;
+    bool    overflow         = false; // ranges beyond capacity were dropped
+};
@@ -0,0 +1,184 @@
+#include "ue_policy.hh"
+
+namespace {
+int be16(const uint8_t* p) { return p[0] << 8u | p[1]; }
+
+// octets after the type identifier, -1 for a type not known here
+int traffic_descriptor_value_length(uint8_t type, const uint8_t* p, int left) {
+    namespace c = traffic_descriptor_component;
+    switch (type) {
+    case c::match_all: return 0;
+    case c::protocol_identifier:
+    case c::ctag_pcp_dei:
+    case c::stag_pcp_dei: return 1;
+    case c::single_remote_port:
+    case c::type_of_service:
+    case c::ctag_vid:
+    case c::stag_vid:
+    case c::ethertype: return 2;
+    case c::flow_label: return 3;
+    case c::remote_port_range:
+    case c::security_param_index: return 4;
+    case c::destination_mac: return 6;
+    case c::ipv4_remote_address: return 8; // address and mask
+    case c::destination_mac_range: return 12;
+    case c::ipv6_remote_address: return 17; // address and prefix length
+    case c::os_id_os_app_id: return left > 16 ? 17 + p[16] : -1; // OS Id, length, app id
+    case c::dnn:
+    case c::connection_caps:
+    case c::destination_fqdn:
+    case c::regular_expression:
+    case c::os_app_id: return left > 0 ? 1 + p[0] : -1;
+    default: return -1;
+    }
+}
+
+int route_selection_value_length(uint8_t type, const uint8_t* p, int left) {
+    namespace c = route_selection_component;
+    switch (type) {
+    case c::multi_access_preference:
+    case c::non_seamless_offload: return 0;
+    case c::ssc_mode:
+    case c::pdu_session_type:
+    case c::preferred_access_type:
+    case c::pdu_session_pair_id:
+    case c::redundancy_sequence_number: return 1;
+    case c::s_nssai:
+    case c::dnn:
+    case c::location_criteria:
+    case c::time_window: return left > 0 ? 1 + p[0] : -1; // length, contents
+    default: return -1;
+    }
+}
+
+// components up to the end or the first unknown one
+void parse_components(const uint8_t* p,
+                      int            left,
+                      int (*value_length)(uint8_t, const uint8_t*, int),
+                      std::vector< ursp_component_t >* ret) {
+    while (left > 0) {
+        const auto type = p[0];
+        const auto l    = value_length(type, p + 1, left - 1);
+        if (l < 0 || 1 + l > left) return;
+
+        ursp_component_t c;
+        c.type = type;
+        c.value.assign(p + 1, p + 1 + l);
+        ret->push_back(std::move(c));
+        p += 1 + l;
+        left -= 1 + l;
+    }
+}
+
+/* D.6.2 UE policy parts of a section: length (2) covering the type octet and the
+ * contents, spare and type, contents */
+bool parse_parts(const octet_t& contents, std::vector< ursp_rule_t >* ursp) {
+    const auto* p    = contents.data();
+    auto        left = int(contents.size());
+    bool        ok   = true;
+    while (left > 0) {
+        if (left < 3) return false;
+        const auto l = be16(p);
+        if (l < 1 || 2 + l > left) return false;
+        if ((p[2] & 0x0fu) == ue_policy_part_type::ursp)
+            ok = parse_ursp(p + 3, l - 1, ursp) && ok;
+        p += 2 + l;
+        left -= 2 + l;
+    }
+    return ok;
+}
+
+uint64_t section_key(const mcc_mnc_t& plmn, uint16_t upsc) {
+    return uint64_t(plmn.mcc) << 32u | uint64_t(plmn.mnc) << 16u | upsc;
+}
+} // namespace
+
+bool parse_ursp(const uint8_t* contents, int length, std::vector< ursp_rule_t >* rules) {
+    const auto* p    = contents;
+    auto        left = length;
+    while (left > 0) {
+        // length (2), precedence (1), length (2) and traffic descriptor, length (2) and
+        // route selection descriptor list
+        if (left < 2) return false;
+        const auto l = be16(p);
+        if (l < 5 || 2 + l > left) return false;
+        const auto* r   = p + 2;
+        const auto  tdl = be16(r + 1);
+        if (3 + tdl + 2 > l) return false;
+        const auto rsdl = be16(r + 3 + tdl);
+        if (3 + tdl + 2 + rsdl > l) return false;
+
+        ursp_rule_t rule;
+        rule.precedence = r[0];
+        parse_components(
+            r + 3, tdl, traffic_descriptor_value_length, &rule.traffic_descriptor);
+
+        // length (2), precedence (1), length (2) and contents
+        const auto* s  = r + 3 + tdl + 2;
+        auto        sl = rsdl;
+        while (sl > 0) {
+            if (sl < 2) return false;
+            const auto dl = be16(s);
+            if (dl < 3 || 2 + dl > sl) return false;
+            const auto cl = be16(s + 3);
+            if (3 + cl > dl) return false;
+
+            route_selection_descriptor_t rsd;
+            rsd.precedence = s[2];
+            parse_components(s + 5, cl, route_selection_value_length, &rsd.components);
+            rule.descriptors.push_back(std::move(rsd));
+            s += 2 + dl;
+            sl -= 2 + dl;
+        }
+        rules->push_back(std::move(rule));
+        p += 2 + l;
+        left -= 2 + l;
+    }
+    return true;
+}
+
+int ue_policy_store::apply(const manage_ue_policy_command_t& cmd) {
+    int changed = 0;
+    for (const auto& sublist : cmd.sections) {
+        for (const auto& instruction : sublist.instructions) {
+            const auto key = section_key(sublist.plmn, instruction.upsc);
+            if (instruction.contents.empty()) {
+                changed += int(sections.erase(key));
+                continue;
+            }
+
+            const auto it = sections.find(key);
+            if (it != sections.end() && it->second.contents == instruction.contents)
+                continue;
+
+            ue_policy_section_t section;
+            section.plmn      = sublist.plmn;
+            section.upsc      = instruction.upsc;
+            section.contents  = instruction.contents;
+            section.malformed = !parse_parts(section.contents, &section.ursp);
+            sections[key]     = std::move(section);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+const ue_policy_section_t* ue_policy_store::find(const mcc_mnc_t& plmn,
+                                                 uint16_t         upsc) const {
+    const auto it = sections.find(section_key(plmn, upsc));
+    return it == sections.end() ? nullptr : &it->second;
+}
+
+std::vector< upsi_sublist_t > ue_policy_store::upsis() const {
+    std::unordered_map< uint32_t, upsi_sublist_t > by_plmn;
+    for (const auto& kv : sections) {
+        auto& sublist = by_plmn[uint32_t(kv.first >> 16u)];
+        sublist.plmn  = kv.second.plmn;
+        sublist.upscs.push_back(kv.second.upsc);
+    }
+
+    std::vector< upsi_sublist_t > ret;
+    ret.reserve(by_plmn.size());
+    for (auto& kv : by_plmn) ret.push_back(std::move(kv.second));
+    return ret;
+}
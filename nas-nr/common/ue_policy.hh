@@ -0,0 +1,191 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "ies.hh"
+
+// D.6.1 UE policy delivery service message type
+namespace updp_message_type {
+inline extern const uint8_t manage_ue_policy_command        = 0x01;
+inline extern const uint8_t manage_ue_policy_complete       = 0x02;
+inline extern const uint8_t manage_ue_policy_command_reject = 0x03;
+inline extern const uint8_t ue_state_indication             = 0x04;
+inline extern const uint8_t ue_policy_provisioning_request  = 0x05;
+inline extern const uint8_t ue_policy_provisioning_reject   = 0x06;
+} // namespace updp_message_type
+
+// D.6.2 UE policy part type
+namespace ue_policy_part_type {
+inline extern const uint8_t ursp   = 1;
+inline extern const uint8_t andsp  = 2;
+inline extern const uint8_t v2xp   = 3;
+inline extern const uint8_t prosep = 4;
+} // namespace ue_policy_part_type
+
+// TS 24.526 table 5.2.1 traffic descriptor component type identifiers
+namespace traffic_descriptor_component {
+inline extern const uint8_t match_all             = 0x01;
+inline extern const uint8_t os_id_os_app_id       = 0x08;
+inline extern const uint8_t ipv4_remote_address   = 0x10;
+inline extern const uint8_t ipv6_remote_address   = 0x21;
+inline extern const uint8_t protocol_identifier   = 0x30;
+inline extern const uint8_t single_remote_port    = 0x50;
+inline extern const uint8_t remote_port_range     = 0x51;
+inline extern const uint8_t security_param_index  = 0x60;
+inline extern const uint8_t type_of_service       = 0x70;
+inline extern const uint8_t flow_label            = 0x80;
+inline extern const uint8_t destination_mac       = 0x81;
+inline extern const uint8_t ctag_vid              = 0x83;
+inline extern const uint8_t stag_vid              = 0x84;
+inline extern const uint8_t ctag_pcp_dei          = 0x85;
+inline extern const uint8_t stag_pcp_dei          = 0x86;
+inline extern const uint8_t ethertype             = 0x87;
+inline extern const uint8_t dnn                   = 0x88;
+inline extern const uint8_t connection_caps       = 0x90;
+inline extern const uint8_t destination_fqdn      = 0x91;
+inline extern const uint8_t regular_expression    = 0x92;
+inline extern const uint8_t os_app_id             = 0xa0;
+inline extern const uint8_t destination_mac_range = 0xa1;
+} // namespace traffic_descriptor_component
+
+// TS 24.526 table 5.2.1 route selection descriptor component type identifiers
+namespace route_selection_component {
+inline extern const uint8_t ssc_mode                   = 0x01;
+inline extern const uint8_t s_nssai                    = 0x02;
+inline extern const uint8_t dnn                        = 0x04;
+inline extern const uint8_t pdu_session_type           = 0x08;
+inline extern const uint8_t preferred_access_type      = 0x10;
+inline extern const uint8_t multi_access_preference    = 0x11;
+inline extern const uint8_t non_seamless_offload       = 0x20;
+inline extern const uint8_t location_criteria          = 0x40;
+inline extern const uint8_t time_window                = 0x80;
+inline extern const uint8_t pdu_session_pair_id        = 0x82;
+inline extern const uint8_t redundancy_sequence_number = 0x83;
+} // namespace route_selection_component
+
+/*
+D.6.2 UE policy section management list, one instruction of a sublist:
+length (2), UPSC (2), UE policy section contents of UE policy parts. An instruction
+without UE policy parts deletes the section.
+*/
+struct ue_policy_instruction_t {
+    uint16_t upsc     = 0; // UE policy section code
+    octet_t  contents = {}; // UE policy parts, empty to delete
+};
+
+struct ue_policy_sublist_t {
+    mcc_mnc_t                              plmn         = {};
+    std::vector< ue_policy_instruction_t > instructions = {};
+};
+
+// D.6.3 UE policy section management result
+struct ue_policy_result_t {
+    uint16_t upsc                     = 0;
+    uint16_t failed_instruction_order = 0;
+    uint8_t  cause                    = 0; // 5GSM cause
+};
+
+struct ue_policy_subresult_t {
+    mcc_mnc_t                         plmn    = {};
+    std::vector< ue_policy_result_t > results = {};
+};
+
+// D.6.4 UPSI list
+struct upsi_sublist_t {
+    mcc_mnc_t               plmn  = {};
+    std::vector< uint16_t > upscs = {};
+};
+
+struct updp_header_t {
+    uint8_t pti          = 0;
+    uint8_t message_type = 0;
+};
+
+// D.5.1 MANAGE UE POLICY COMMAND
+struct manage_ue_policy_command_t {
+    updp_header_t                      header            = {};
+    std::vector< ue_policy_sublist_t > sections          = {}; // LV-E
+    opt_t< octet_t >                   network_classmark = {}; // 42 TLV 3-5
+};
+
+// D.5.2 MANAGE UE POLICY COMPLETE
+struct manage_ue_policy_complete_t {
+    updp_header_t header = {};
+};
+
+// D.5.3 MANAGE UE POLICY COMMAND REJECT
+struct manage_ue_policy_command_reject_t {
+    updp_header_t                        header  = {};
+    std::vector< ue_policy_subresult_t > results = {}; // LV-E
+};
+
+// D.5.4 UE STATE INDICATION
+struct ue_state_indication_t {
+    updp_header_t                 header    = {};
+    std::vector< upsi_sublist_t > upsis     = {}; // LV-E
+    octet_t                       classmark = {}; // LV
+    opt_t< octet_t >              os_ids    = {}; // 41 TLV
+};
+
+struct updp_message_t {
+    updp_header_t                                        header = {};
+    std::shared_ptr< manage_ue_policy_command_t >        manage_ue_policy_command;
+    std::shared_ptr< manage_ue_policy_complete_t >       manage_ue_policy_complete;
+    std::shared_ptr< manage_ue_policy_command_reject_t > manage_ue_policy_command_reject;
+    std::shared_ptr< ue_state_indication_t >             ue_state_indication;
+};
+
+result_t de_updp_message(dissector d, context* ctx, updp_message_t* ret);
+
+// one traffic descriptor or route selection descriptor component, value is what follows
+// the type identifier, with the length octet of a variable length component
+struct ursp_component_t {
+    uint8_t type  = 0;
+    octet_t value = {};
+};
+
+// TS 24.526 5.2 route selection descriptor
+struct route_selection_descriptor_t {
+    uint8_t                         precedence = 0;
+    std::vector< ursp_component_t > components = {};
+};
+
+// TS 24.526 5.2 URSP rule
+struct ursp_rule_t {
+    uint8_t                                     precedence         = 0;
+    std::vector< ursp_component_t >             traffic_descriptor = {};
+    std::vector< route_selection_descriptor_t > descriptors        = {};
+};
+
+/* URSP rules of the contents of a URSP UE policy part, appended to rules. A component
+ * of an unknown type ends its traffic or route selection descriptor, the rest of it is
+ * skipped. False when a length runs past the contents, the rules before it are kept. */
+bool parse_ursp(const uint8_t* contents, int length, std::vector< ursp_rule_t >* rules);
+
+// D.6.2 a UE policy section as its parts, with the URSP rules of its URSP parts
+struct ue_policy_section_t {
+    mcc_mnc_t                  plmn      = {};
+    uint16_t                   upsc      = 0;
+    octet_t                    contents  = {}; // UE policy parts as delivered
+    std::vector< ursp_rule_t > ursp      = {};
+    bool                       malformed = false; // a part or URSP rule did not parse
+};
+
+/* UE policy sections of one UE keyed by PSI, the PLMN and UPSC pair of D.2.1. A
+ * MANAGE UE POLICY COMMAND carries instructions per section: contents add or replace a
+ * section, none delete it. Only sections whose contents changed are parsed again, so a
+ * delta costs what it delivers rather than the size of the whole policy. */
+struct ue_policy_store {
+    // applies every instruction, returns how many sections were added, replaced or
+    // deleted; one delivered again unchanged does not count
+    int apply(const manage_ue_policy_command_t& cmd);
+
+    const ue_policy_section_t* find(const mcc_mnc_t& plmn, uint16_t upsc) const;
+
+    // the UPSIs stored, as a UE STATE INDICATION lists them
+    std::vector< upsi_sublist_t > upsis() const;
+
+    std::unordered_map< uint64_t, ue_policy_section_t > sections = {};
+};
@@ -0,0 +1,418 @@
+#include "ue_tracker.hh"
+
+#include "definitions.hh"
+#include "dissects.hh"
+#include "messages.hh"
+#include "packet.hh"
+#include "payload_container.hh"
+
+namespace {
+// 9.11.3.4 type of identity
+const uint8_t nmid_none   = 0;
+const uint8_t nmid_suci   = 1;
+const uint8_t nmid_guti   = 2;
+const uint8_t nmid_s_tmsi = 4;
+
+// stands in for a caller key of 0, which marks empty slots
+const uint64_t zero_key = 0x9e3779b97f4a7c15ULL;
+
+// splitmix64 finalizer
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30u;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27u;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31u);
+}
+
+// AMF Set ID, AMF Pointer and 5G-TMSI, 6 octets
+uint64_t tmsi_key(const uint8_t* p) {
+    uint64_t v = uint64_t(1) << 48u;
+    for (int i = 0; i < 6; ++i) v |= uint64_t(p[i]) << (8u * (5u - i));
+    return v;
+}
+
+uint64_t hashed_key(const uint8_t* p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ULL;
+    return h | uint64_t(1) << 63u;
+}
+
+// p starts at octet 4 of the 5GS mobile identity, the type of identity
+bool nmid_key(const uint8_t* p, size_t n, uint64_t* key) {
+    if (n < 1) return false;
+    switch (p[0] & 0x07u) {
+    case nmid_none:
+        return false;
+    case nmid_guti:
+        if (n < 11) return false;
+        *key = tmsi_key(p + 5);
+        return true;
+    case nmid_s_tmsi:
+        if (n < 7) return false;
+        *key = tmsi_key(p + 1);
+        return true;
+    default:
+        *key = hashed_key(p, n);
+        return true;
+    }
+}
+
+// 9.11.3.4 SUCI of SUPI format IMSI and 5G-GUTI carry the PLMN after the type octet
+bool nmid_plmn(const uint8_t* p, size_t n, uint32_t* plmn) {
+    if (n < 4) return false;
+    const auto type = p[0] & 0x07u;
+    if (type == nmid_suci && (p[0] & 0x70u) != 0) return false;
+    if (type != nmid_suci && type != nmid_guti) return false;
+    *plmn = uint32_t(p[1]) << 16u | uint32_t(p[2]) << 8u | p[3];
+    return true;
+}
+
+const nas_message_plain_t* plain_of(const nas_message_t& msg) {
+    if (msg.plain) return msg.plain.get();
+    if (msg.protect) return &msg.protect->plain;
+    return nullptr;
+}
+
+struct track_context {
+    ue_state_t*      st;
+    uint64_t*        replaced;
+    procedure_event* ev;
+    uint32_t         now_us;
+    int64_t          now_ns;
+};
+
+void open(track_context& t, ue_procedure_t* slot, uint8_t kind, uint8_t psi, uint8_t pti,
+          uint8_t request) {
+    if (slot->kind != procedure::none) ++*t.replaced;
+    *slot = {kind, psi, pti, request, t.now_us};
+}
+
+bool close(track_context& t, ue_procedure_t* slot, uint8_t result, uint8_t response,
+           uint8_t cause) {
+    auto* ev        = t.ev;
+    ev->ue          = t.st->key;
+    ev->kind        = slot->kind;
+    ev->result      = result;
+    ev->psi         = slot->psi;
+    ev->pti         = slot->pti;
+    ev->request     = slot->request;
+    ev->response    = response;
+    ev->cause       = cause;
+    ev->duration_us = t.now_us - slot->start;
+    ev->end         = t.now_ns;
+    *slot           = {};
+    return true;
+}
+
+// closes the 5GMM specific (0) or common (1) procedure if it is of kind
+bool close_mm(track_context& t, int i, uint8_t kind, uint8_t result, uint8_t response,
+              uint8_t cause = 0) {
+    auto* slot = &t.st->mm[i];
+    if (slot->kind != kind) return false;
+    return close(t, slot, result, response, cause);
+}
+
+bool on_nmm(track_context& t, const nmm_message_t& m) {
+    auto*      st   = t.st;
+    const auto type = m.header.message_type;
+    switch (type) {
+    case 0x41: // registration request
+        open(t, &st->mm[0], procedure::registration, 0, 0, type);
+        return false;
+    case 0x42: // registration accept
+        st->registered = 1;
+        return close_mm(t, 0, procedure::registration, outcome::success, type);
+    case 0x44: // registration reject ends whatever common procedure ran inside it
+        st->mm[1] = {};
+        return close_mm(t, 0, procedure::registration, outcome::failure, type,
+                        m.registration_reject ? m.registration_reject->cause : 0);
+    case 0x45: // deregistration request (UE originating)
+    case 0x47: // deregistration request (UE terminated)
+        open(t, &st->mm[0], procedure::deregistration, 0, 0, type);
+        return false;
+    case 0x46: // deregistration accept (UE originating)
+    case 0x48: // deregistration accept (UE terminated)
+        st->registered = 0;
+        st->sessions   = 0;
+        return close_mm(t, 0, procedure::deregistration, outcome::success, type);
+    case 0x4c: // service request
+        open(t, &st->mm[0], procedure::service_request, 0, 0, type);
+        return false;
+    case 0x4d: // service reject
+        return close_mm(t, 0, procedure::service_request, outcome::failure, type,
+                        m.service_reject ? m.service_reject->nmm_cause : 0);
+    case 0x4e: // service accept
+        return close_mm(t, 0, procedure::service_request, outcome::success, type);
+    case 0x56: // authentication request
+        open(t, &st->mm[1], procedure::authentication, 0, 0, type);
+        return false;
+    case 0x57: // authentication response
+        return close_mm(t, 1, procedure::authentication, outcome::success, type);
+    case 0x58: // authentication reject
+        return close_mm(t, 1, procedure::authentication, outcome::failure, type);
+    case 0x59: // authentication failure
+        return close_mm(t, 1, procedure::authentication, outcome::failure, type,
+                        m.authentication_failure ? m.authentication_failure->cause : 0);
+    case 0x5d: // security mode command
+        open(t, &st->mm[1], procedure::security_mode, 0, 0, type);
+        return false;
+    case 0x5e: // security mode complete
+        return close_mm(t, 1, procedure::security_mode, outcome::success, type);
+    case 0x5f: // security mode reject
+        return close_mm(t, 1, procedure::security_mode, outcome::failure, type,
+                        m.security_mode_reject ? m.security_mode_reject->cause : 0);
+    default:
+        return false;
+    }
+}
+
+// pending 5GSM procedure of kind on psi; a PTI of 0 (network initiated) matches any
+ue_procedure_t* find_sm(ue_state_t* st, uint8_t kind, uint8_t psi, uint8_t pti) {
+    for (auto& p : st->sm) {
+        if (p.kind != kind || p.psi != psi) continue;
+        if (pti == 0 || p.pti == 0 || p.pti == pti) return &p;
+    }
+    return nullptr;
+}
+
+// a free 5GSM slot, or the one waiting longest
+ue_procedure_t* free_sm(ue_state_t* st, uint32_t now_us) {
+    ue_procedure_t* oldest = &st->sm[0];
+    for (auto& p : st->sm) {
+        if (p.kind == procedure::none) return &p;
+        if (now_us - p.start > now_us - oldest->start) oldest = &p;
+    }
+    return oldest;
+}
+
+bool close_sm(track_context& t, uint8_t kind, const nsm_header_t& h, uint8_t result,
+              uint8_t cause = 0) {
+    auto* slot = find_sm(t.st, kind, h.pdu_session_id, h.pti);
+    if (!slot) return false;
+    return close(t, slot, result, h.message_type, cause);
+}
+
+bool on_nsm(track_context& t, const nsm_message_t& m) {
+    auto*       st   = t.st;
+    const auto& h    = m.header;
+    const auto  psi  = uint8_t(h.pdu_session_id & 0x0fu);
+    const auto  bit  = uint16_t(1u << psi);
+    const auto  type = h.message_type;
+    switch (type) {
+    case 0xc1: // PDU session establishment request
+        open(t, free_sm(st, t.now_us), procedure::pdu_session_establishment, psi, h.pti, type);
+        return false;
+    case 0xc2: // PDU session establishment accept
+        st->sessions |= bit;
+        return close_sm(t, procedure::pdu_session_establishment, h, outcome::success);
+    case 0xc3: // PDU session establishment reject
+        return close_sm(t,
+                        procedure::pdu_session_establishment,
+                        h,
+                        outcome::failure,
+                        m.pdu_session_establishment_reject
+                            ? m.pdu_session_establishment_reject->nsm_cause
+                            : 0);
+    case 0xc9: // PDU session modification request
+        open(t, free_sm(st, t.now_us), procedure::pdu_session_modification, psi, h.pti, type);
+        return false;
+    case 0xca: // PDU session modification reject
+        return close_sm(t,
+                        procedure::pdu_session_modification,
+                        h,
+                        outcome::failure,
+                        m.pdu_session_modification_reject
+                            ? m.pdu_session_modification_reject->nsm_cause
+                            : 0);
+    case 0xcb: // PDU session modification command, answers a request or starts one
+        if (!find_sm(st, procedure::pdu_session_modification, psi, h.pti))
+            open(t, free_sm(st, t.now_us), procedure::pdu_session_modification, psi, h.pti,
+                 type);
+        return false;
+    case 0xcc: // PDU session modification complete
+        return close_sm(t, procedure::pdu_session_modification, h, outcome::success);
+    case 0xcd: // PDU session modification command reject
+        return close_sm(t,
+                        procedure::pdu_session_modification,
+                        h,
+                        outcome::failure,
+                        m.pdu_session_modification_command_reject
+                            ? m.pdu_session_modification_command_reject->nsm_cause
+                            : 0);
+    case 0xd1: // PDU session release request
+        open(t, free_sm(st, t.now_us), procedure::pdu_session_release, psi, h.pti, type);
+        return false;
+    case 0xd2: // PDU session release reject
+        return close_sm(
+            t,
+            procedure::pdu_session_release,
+            h,
+            outcome::failure,
+            m.pdu_session_release_reject ? m.pdu_session_release_reject->nsm_cause : 0);
+    case 0xd3: // PDU session release command, answers a request or starts one
+        if (!find_sm(st, procedure::pdu_session_release, psi, h.pti))
+            open(t, free_sm(st, t.now_us), procedure::pdu_session_release, psi, h.pti, type);
+        return false;
+    case 0xd4: // PDU session release complete
+        st->sessions &= uint16_t(~bit);
+        return close_sm(t, procedure::pdu_session_release, h, outcome::success);
+    default:
+        return false;
+    }
+}
+
+uint32_t probe(const std::vector< ue_state_t >& slots, uint64_t key) {
+    const auto mask = uint32_t(slots.size() - 1);
+    auto       i    = uint32_t(mix64(key)) & mask;
+    while (slots[i].key != 0 && slots[i].key != key) i = (i + 1) & mask;
+    return i;
+}
+
+// backward shift deletion, keeps probe sequences intact without tombstones
+void erase(std::vector< ue_state_t >& slots, uint32_t i) {
+    const auto mask = uint32_t(slots.size() - 1);
+    auto       j    = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (slots[j].key == 0) break;
+        const auto home  = uint32_t(mix64(slots[j].key)) & mask;
+        const bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (stays) continue;
+        slots[i] = slots[j];
+        i        = j;
+    }
+    slots[i] = {};
+}
+
+// the 5GSM message of a UL or DL NAS transport, decoded into scratch when left raw
+template < typename transport_t >
+const nsm_message_t* transported_nsm(const transport_t& m, nsm_message_t* scratch) {
+    if (m.n1_sm) return m.n1_sm.get();
+    if (m.payload_container_type != payload_container_kind::n1_sm_information ||
+        m.payload_container.empty())
+        return nullptr;
+
+    const auto* p = m.payload_container.data();
+    const auto  n = int(m.payload_container.size());
+    de_nsm_message(dissector{nullptr, p, n, 0, n}, nullptr, scratch);
+    return scratch;
+}
+} // namespace
+
+
+bool nas_ue_key(const nas_message_t& msg, uint64_t* key) {
+    const auto* plain = plain_of(msg);
+    if (!plain || !plain->nmm || !key) return false;
+
+    const auto& m = *plain->nmm;
+    if (m.registration_request)
+        return nmid_key(m.registration_request->nr_mid.data(),
+                        m.registration_request->nr_mid.size(),
+                        key);
+    if (m.service_request)
+        return nmid_key(m.service_request->tmsi_nmid, sizeof(m.service_request->tmsi_nmid), key);
+    if (m.deregistration_request_ue_orig)
+        return nmid_key(m.deregistration_request_ue_orig->nr_mid.data(),
+                        m.deregistration_request_ue_orig->nr_mid.size(),
+                        key);
+    if (m.identity_response)
+        return nmid_key(m.identity_response->nmid.data(), m.identity_response->nmid.size(), key);
+    return false;
+}
+
+bool nas_plmn(const nas_message_t& msg, uint32_t* plmn) {
+    const auto* plain = plain_of(msg);
+    if (!plain || !plain->nmm || !plmn) return false;
+
+    const auto& m = *plain->nmm;
+    if (m.registration_request)
+        return nmid_plmn(m.registration_request->nr_mid.data(),
+                         m.registration_request->nr_mid.size(),
+                         plmn);
+    if (m.registration_accept && m.registration_accept->guti_nr_mid.present)
+        return nmid_plmn(m.registration_accept->guti_nr_mid.v,
+                         sizeof(m.registration_accept->guti_nr_mid.v),
+                         plmn);
+    if (m.identity_response)
+        return nmid_plmn(m.identity_response->nmid.data(),
+                         m.identity_response->nmid.size(),
+                         plmn);
+    return false;
+}
+
+ue_tracker::ue_tracker(uint32_t capacity) {
+    uint32_t n = 16;
+    while (n < capacity) n <<= 1u;
+    slots.resize(n);
+}
+
+const ue_state_t* ue_tracker::find(uint64_t ue) const {
+    if (ue == 0) ue = zero_key;
+    const auto i = probe(slots, ue);
+    return slots[i].key == ue ? &slots[i] : nullptr;
+}
+
+bool ue_tracker::track(uint64_t             ue,
+                       const nas_message_t& msg,
+                       const packet*        pkt,
+                       procedure_event*     ev) {
+    const auto* plain = plain_of(msg);
+    if (!plain || (!plain->nmm && !plain->nsm) || !ev) return false;
+    if (ue == 0) ue = zero_key;
+
+    if ((used + 1) * 4 > slots.size() * 3) {
+        std::vector< ue_state_t > old(slots.size() * 2);
+        old.swap(slots);
+        for (const auto& s : old)
+            if (s.key != 0) slots[probe(slots, s.key)] = s;
+    }
+
+    const auto i  = probe(slots, ue);
+    auto*      st = &slots[i];
+    if (st->key == 0) {
+        st->key = ue;
+        ++used;
+    }
+
+    const int64_t now = pkt ? pkt->abs_timestamp : 0;
+    track_context t   = {st, &replaced, ev, uint32_t(now / 1000), now};
+    st->last_seen     = uint32_t(now / 1000000000);
+
+    bool closed = false;
+    if (plain->nmm) closed = on_nmm(t, *plain->nmm);
+    if (plain->nsm) closed = on_nsm(t, *plain->nsm) || closed;
+
+    // PDU session procedures travel in NAS transports, keyed by their own PDU session ID
+    if (plain->nmm) {
+        nsm_message_t        scratch = {};
+        const nsm_message_t* sm      = nullptr;
+        if (plain->nmm->ul_nas_transport)
+            sm = transported_nsm(*plain->nmm->ul_nas_transport, &scratch);
+        if (plain->nmm->dl_nas_transport)
+            sm = transported_nsm(*plain->nmm->dl_nas_transport, &scratch);
+        if (sm) closed = on_nsm(t, *sm) || closed;
+    }
+
+    // nothing left to follow once the UE has deregistered
+    if (closed && ev->kind == procedure::deregistration) {
+        erase(slots, i);
+        --used;
+    }
+    return closed;
+}
+
+uint32_t ue_tracker::age(uint32_t now, uint32_t idle) {
+    uint32_t dropped = 0;
+    for (uint32_t i = 0; i < slots.size();) {
+        if (slots[i].key != 0 && now - slots[i].last_seen >= idle) {
+            // the shift may pull another candidate into i, look at it again
+            erase(slots, i);
+            --used;
+            ++dropped;
+            continue;
+        }
+        ++i;
+    }
+    return dropped;
+}
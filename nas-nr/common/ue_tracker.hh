@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct nas_message_t;
+struct packet;
+
+namespace procedure {
+inline extern const uint8_t none                      = 0;
+inline extern const uint8_t registration              = 1;
+inline extern const uint8_t deregistration            = 2;
+inline extern const uint8_t service_request           = 3;
+inline extern const uint8_t authentication            = 4;
+inline extern const uint8_t security_mode             = 5;
+inline extern const uint8_t pdu_session_establishment = 6;
+inline extern const uint8_t pdu_session_modification  = 7;
+inline extern const uint8_t pdu_session_release       = 8;
+} // namespace procedure
+
+namespace outcome {
+inline extern const uint8_t success = 1;
+inline extern const uint8_t failure = 2; // reject, failure or command reject
+} // namespace outcome
+
+// one procedure waiting for its final message, 8 bytes
+struct ue_procedure_t {
+    uint8_t  kind    = 0; // procedure::*, none for a free slot
+    uint8_t  psi     = 0; // PDU session identity, 0 for 5GMM
+    uint8_t  pti     = 0; // procedure transaction identity, 0 when network initiated
+    uint8_t  request = 0; // message type that opened it
+    uint32_t start   = 0; // packet time in microseconds, modulo 2^32
+};
+
+// per-UE state, one cache line
+struct ue_state_t {
+    uint64_t       key        = 0; // 0 marks an empty slot
+    uint32_t       last_seen  = 0; // packet time in seconds
+    uint16_t       sessions   = 0; // bit n set while PDU session n is established
+    uint8_t        registered = 0;
+    uint8_t        spare      = 0;
+    ue_procedure_t mm[2]      = {}; // 5GMM specific and 5GMM common procedure
+    ue_procedure_t sm[4]      = {}; // 5GSM procedures in flight
+};
+
+// a procedure that reached its final message
+struct procedure_event {
+    uint64_t ue          = 0;
+    uint8_t  kind        = 0; // procedure::*
+    uint8_t  result      = 0; // outcome::*
+    uint8_t  psi         = 0;
+    uint8_t  pti         = 0;
+    uint8_t  request     = 0; // message type that opened the procedure
+    uint8_t  response    = 0; // message type that closed it
+    uint8_t  cause       = 0; // 5GMM or 5GSM cause on failure, 0 when none was sent
+    uint32_t duration_us = 0;
+    int64_t  end         = 0; // packet abs_timestamp of the closing message
+};
+
+/* Key for the UE a message identifies itself with: 5G-GUTI and 5G-S-TMSI map to the
+ * same key so a service request finds the UE registered under the GUTI; SUCI and
+ * permanent identities are hashed. False when the message carries no identity, then
+ * the transport association (e.g. RAN UE NGAP ID) has to be the key. */
+bool nas_ue_key(const nas_message_t& msg, uint64_t* key);
+
+/* PLMN of the SUCI or 5G-GUTI in a Registration Request, Registration Accept or Identity
+ * Response, as the three octets of 9.11.3.4 packed big endian: MCC digit 2 | MCC digit 1,
+ * MNC digit 3 | MCC digit 3, MNC digit 2 | MNC digit 1. */
+bool nas_plmn(const nas_message_t& msg, uint32_t* plmn);
+
+/* Correlates decoded NAS messages into 5GMM and 5GSM procedures per UE.
+ * State lives in flat ue_state_t slots of a linear probing table that doubles when
+ * three quarters full. Not synchronized: run one tracker per thread and partition UEs
+ * between them. */
+struct ue_tracker {
+    explicit ue_tracker(uint32_t capacity = 1024);
+
+    // feeds msg of ue, true when it closed a procedure and ev was filled
+    bool track(uint64_t ue, const nas_message_t& msg, const packet* pkt, procedure_event* ev);
+
+    const ue_state_t* find(uint64_t ue) const;
+
+    // drops UEs not seen for idle seconds, returns how many
+    uint32_t age(uint32_t now, uint32_t idle);
+
+    std::vector< ue_state_t > slots    = {};
+    uint32_t                  used     = 0;
+    uint64_t                  replaced = 0; // procedures dropped by a newer one in the slot
+};
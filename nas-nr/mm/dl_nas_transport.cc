@@ -1,5 +1,6 @@
 #include "../common/dissector.hh"
 #include "../common/messages.hh"
+#include "../common/payload_container.hh"
 #include "../common/use_context.hh"
 
 /*  8.2.11 DL NAS transport */
@@ -24,6 +25,7 @@ result_t de_dl_nas_transport(dissector d, context* ctx, dl_nas_transport_t* ret)
     // Spare half octet	Spare half octet	9.5	M	V	1/2
 
     // Payload container	Payload container	9.11.3.39	M	LV-E	3-65537
+    de_n1_sm_payload(d, ctx, ret->payload_container_type, &ret->n1_sm);
     de_le_octet(d, ctx, &ret->payload_container).step(d);
 
     // 12	PDU session ID	PDU session identity 2	9.11.3.41	C	TV	2
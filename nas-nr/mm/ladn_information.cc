@@ -12,11 +12,11 @@ result_t die_partial_tai_list_00(dissector d, context* ctx, partial_tai_list_00_
 
     die_mcc_mnc(d, ctx, &ret->mccmnc).step(d);
 
-    for (auto n = ret->number; n > 0;) {
+    // number of elements is encoded minus one
+    for (auto n = ret->number + 1; n > 0 && d.length > 0; --n) {
         o3_t o3 = {};
         de_fixed(d, ctx, o3.v).step(d);
         ret->taces.push_back(o3);
-        --n;
     }
     return {uc.consumed()};
 }
@@ -30,12 +30,6 @@ result_t die_partial_tai_list_01(dissector d, context* ctx, partial_tai_list_01_
     die_mcc_mnc(d, ctx, &ret->mccmnc).step(d);
     de_fixed(d, ctx, ret->tac).step(d);
 
-    for (auto n = ret->number; n > 1; --n) {
-        o3_t o3 = {};
-        de_fixed(d, ctx, o3.v).step(d);
-        ret->others.push_back(o3);
-    }
-
     return {uc.consumed()};
 }
 //* 9.11.3.8     5GS tracking area identity
@@ -45,11 +39,10 @@ result_t die_partial_tai_list_10(dissector d, context* ctx, partial_tai_list_10_
     de_uint8(d, ctx, &ret->number, 0x1fu);
     de_uint8(d, ctx, &ret->type, 0x60u).step(d);
 
-    for (auto n = ret->number; n > 0;) {
+    for (auto n = ret->number + 1; n > 0 && d.length > 0; --n) {
         nr_tracking_area_id_t tai = {};
         die_nr_tracking_area_id(d, ctx, &tai).step(d);
         ret->ids.push_back(tai);
-        --n;
     }
     return {uc.consumed()};
 }
@@ -82,8 +75,9 @@ result_t die_nr_tracking_id_list(dissector                   d,
     const use_context uc(&d, ctx, "nr-tracking-area-id-list", 0);
 
     while (d.length > 0) {
-        partial_tai_t ptai = {};
-        die_partial_tai(d, ctx, &ptai).step(d);
+        partial_tai_t ptai     = {};
+        const auto    consumed = die_partial_tai(d, ctx, &ptai).step(d);
+        if (consumed == 0) break; // reserved type of list, length unknown
         ret->partials.push_back(ptai);
     }
     return {uc.length};
@@ -2,6 +2,23 @@
 #include "../common/use_context.hh"
 #include "../common/messages.hh"
 
+/* 9.11.3.37    NSSAI
+ * S-NSSAI value is coded as the length and value part of S-NSSAI information element
+as specified in subclause 9.11.2.8 starting with the second octet.
+ */
+result_t die_nssai(dissector d, context* ctx, nssai_t* ret) {
+    const use_context uc(&d, ctx, "nssai", 0);
+
+    while (d.length > 0) {
+        s_nssai_t v = {};
+        auto      l = d.uint8(true);
+        die_s_nssai(d.slice(l), ctx, &v);
+        d.step(l);
+        ret->s_nssai.push_back(v);
+    }
+    return {uc.length};
+}
+
 /* 9.11.3.37    NSSAI */
 int dissect_configured_nssai(dissector d, context* ctx) {
     const use_context uc(&d, ctx, "configured-nssai", 0);
@@ -1,7 +1,41 @@
 #include "../common/dissector.hh"
+#include "../common/intern.hh"
 #include "../common/messages.hh"
 #include "../common/use_context.hh"
 
+namespace {
+/* Figure 9.11.3.38.3 criteria components, a type, a count and the values. A component
+ * of an unknown type ends the criteria, its length is not known. */
+void de_criteria(dissector d, context* ctx, access_category_criteria_t* ret) {
+    namespace c = access_category_criteria;
+    const use_context uc(&d, ctx, "criteria", -1);
+    while (d.length >= 2) {
+        const auto type = d.uint8(true);
+        const auto n    = d.uint8(true);
+        if (type > c::s_nssai) break;
+        ret->types |= uint8_t(1u << type);
+
+        for (auto i = 0; i < n && d.length > 0; ++i) {
+            const auto* p = d.safe_ptr();
+            if (type == c::os_id_os_app_id) {
+                // OS Id, length of OS App Id, OS App Id
+                if (d.length < 17 || 17 + p[16] > d.length) return;
+                ret->os_apps.emplace_back(p, p + 17 + p[16]);
+                d.step(17 + p[16]);
+                continue;
+            }
+            if (1 + p[0] > d.length) return;
+            if (type == c::dnn) ret->dnn_ids.push_back(intern_dnn(p + 1, p[0]));
+            if (type == c::s_nssai) {
+                const octet_t nssai(p + 1, p + 1 + p[0]);
+                ret->s_nssai_ids.push_back(intern_s_nssai_octets(nssai));
+            }
+            d.step(1 + p[0]);
+        }
+    }
+}
+} // namespace
+
 /*  9.11.3.38    Operator-defined access category definitions */
 result_t die_operator_defined_access_category_definition(
     dissector                                      d,
@@ -13,6 +47,8 @@ result_t die_operator_defined_access_category_definition(
     de_uint8(d, ctx, &ret->psac, 0x80u);
     de_uint8(d, ctx, &ret->number, 0x1fu).step(d);
 
+    const auto l = d.uint8(false);
+    if (l < d.length) de_criteria(d.slice(l + 1).step(1), ctx, &ret->components);
     de_l_octet(d, ctx, &ret->criteria).step(d);
     if (d.length > 0) {
         ret->standardized_access_category.present = true;
@@ -28,10 +64,11 @@ result_t die_operator_defined_access_category_definitions(
     operator_defined_access_category_definitions_t* ret) {
     const use_context uc(&d, ctx, "operator-defined-access-category-definitions", 0);
     while (d.length > 0) {
-        auto                                          l = d.uint8(true);
+        auto l = d.uint8(true);
+        if (l > d.length) break;
         operator_defined_access_category_definition_t v = {};
         die_operator_defined_access_category_definition(d.slice(l), ctx, &v).step(d);
-        ret->definitions.push_back(v);
+        ret->definitions.push_back(std::move(v));
     }
     return {uc.length};
 }
@@ -1,29 +1,140 @@
 #include "../common/dissector.hh"
+#include "../common/dissects.hh"
+#include "../common/payload_container.hh"
+#include "../common/ue_policy.hh"
 #include "../common/use_context.hh"
 
-int dissect_pld_container_entry(dissector d, context* ctx) {
-    const use_context uc(&d, ctx, "pld-content-entry",-1);
-
-    return 0;
+bool payload_entry_view::optional_ie(uint8_t type, const uint8_t** value, int* length) const {
+    const auto* p    = optional_ies;
+    auto        left = optional_ies_length;
+    while (left >= 2) {
+        const int l = p[1];
+        if (2 + l > left) break;
+        if (p[0] == type) {
+            *value  = p + 2;
+            *length = l;
+            return true;
+        }
+        p += 2 + l;
+        left -= 2 + l;
+    }
+    return false;
 }
 
 /*  9.11.3.39    Payload container */
-int dissect_payload_container(dissector d, context* ctx) {
-    const use_context uc(&d, ctx, "pld-content", 0);
+payload_entry_iterator payload_entries(uint8_t type, const uint8_t* contents, int length) {
+    payload_entry_iterator it;
+    it.type = type;
+    if (!contents || length <= 0) return it;
+
+    if (type != payload_container_kind::multiple_payloads) {
+        it.p       = contents;
+        it.left    = length;
+        it.entries = 1;
+        return it;
+    }
+    // Figure 9.11.3.39.1 number of entries, then the entries
+    it.entries = contents[0];
+    it.p       = contents + 1;
+    it.left    = length - 1;
+    return it;
+}
 
-    return uc.length;
+payload_entry_iterator payload_entries(const ul_nas_transport_t& msg) {
+    return payload_entries(msg.payload_container_type,
+                           msg.payload_container.data(),
+                           int(msg.payload_container.size()));
 }
 
-/* UPDP */
-/* D.6.1 UE policy delivery service message type */
-int dissect_ue_policy_delivery_procedure(dissector d, context* ctx) {
-    const use_context uc(&d, ctx, "updp", 0);
-    return uc.length;
+payload_entry_iterator payload_entries(const dl_nas_transport_t& msg) {
+    return payload_entries(msg.payload_container_type,
+                           msg.payload_container.data(),
+                           int(msg.payload_container.size()));
 }
 
-int dissect_optional_ie(dissector d, context* ctx) {
-    const use_context uc(&d, ctx, "optional-ie", -1);
+bool payload_entry_iterator::next(payload_entry_view* ret) {
+    if (entries <= 0 || malformed) return false;
+    --entries;
+    *ret = {};
+
+    if (type != payload_container_kind::multiple_payloads) {
+        ret->type     = type;
+        ret->contents = p;
+        ret->length   = left;
+        left          = 0;
+        return true;
+    }
+
+    // Figure 9.11.3.39.2 length of entry, number of optional IEs and type, optional IEs,
+    // then the entry contents
+    if (left < 3) {
+        malformed = true;
+        return false;
+    }
+    const int length = p[0] << 8u | p[1];
+    if (length < 1 || 2 + length > left) {
+        malformed = true;
+        return false;
+    }
+    const auto* e       = p + 2;
+    ret->type           = e[0] & 0x0fu;
+    ret->optional_ies_n = e[0] >> 4u;
+
+    int i = 1;
+    for (auto n = 0; n < ret->optional_ies_n; ++n) {
+        if (i + 2 > length || i + 2 + e[i + 1] > length) {
+            malformed = true;
+            return false;
+        }
+        i += 2 + e[i + 1];
+    }
+    ret->optional_ies        = e + 1;
+    ret->optional_ies_length = i - 1;
+    ret->contents            = e + i;
+    ret->length              = length - i;
+
+    p += 2 + length;
+    left -= 2 + length;
+    return true;
+}
+
+result_t de_payload(const payload_entry_view& entry, context* ctx, payload_t* ret) {
+    ret->entry = entry;
+    auto d     = dissector{nullptr, entry.contents, entry.length, 0, entry.length};
+    const use_context uc(&d, ctx, "payload-container-entry", 0);
+
+    switch (entry.type) {
+    case payload_container_kind::n1_sm_information:
+        ret->n1_sm = std::make_shared< nsm_message_t >();
+        de_nsm_message(d, ctx, ret->n1_sm.get()).step(d);
+        break;
+    case payload_container_kind::sor:
+        ret->sor = std::make_shared< sor_transparent_container_t >();
+        die_sor_transparent_container(d, ctx, ret->sor.get()).step(d);
+        break;
+    case payload_container_kind::ue_policy:
+        ret->ue_policy = std::make_shared< updp_message_t >();
+        de_updp_message(d, ctx, ret->ue_policy.get()).step(d);
+        break;
+    default:
+        d.step(d.length); // kept as the entry view
+        break;
+    }
+    return {entry.length};
+}
 
+result_t de_n1_sm_payload(dissector                         d,
+                          context*                          ctx,
+                          uint8_t                           type,
+                          std::shared_ptr< nsm_message_t >* ret) {
+    const auto length = int(d.uint16(true));
+    if (type != payload_container_kind::n1_sm_information) return {2 + length};
+    if (!ctx || ctx->n1_sm_depth >= ctx->n1_sm_depth_limit) return {2 + length};
 
-    return d.offset - uc.offset;
+    // a length past the contents would read the optional IEs that follow as 5GSM
+    ++ctx->n1_sm_depth;
+    *ret = std::make_shared< nsm_message_t >();
+    de_nsm_message(d.slice(length > d.length ? d.length : length), ctx, ret->get());
+    --ctx->n1_sm_depth;
+    return {2 + length};
 }
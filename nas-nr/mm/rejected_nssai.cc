@@ -10,9 +10,10 @@ result_t die_rejected_nssai(dissector d, context* ctx, rejected_nssai_t* ret) {
         auto                      l = mask_u8(d.uint8(false), 0xf0u);
         de_uint8(d, ctx, &n.cause, 0x0fu).step(d);
         de_uint8(d, ctx, &n.sst).step(d);
-        if (l > 2) {
+        // the length counts SST and SD, not the octet holding it
+        if (l > 1) {
             n.sd.present = true;
-            de_octet(d.slice(l - 2), ctx, &n.sd.v).step(d);
+            de_octet(d.slice(l - 1), ctx, &n.sd.v).step(d);
         }
         ret->nssais.push_back(n);
     }
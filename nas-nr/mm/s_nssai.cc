@@ -1,5 +1,7 @@
-#include "dissector.hh"
-#include "use_context.hh"
+#include "../common/dissector.hh"
+#include "../common/ies.hh"
+#include "../common/intern.hh"
+#include "../common/use_context.hh"
 
 //    9.11.2.8	S-NSSAI
 result_t die_s_nssai(dissector d, context* ctx, s_nssai_t* ret) {
@@ -25,5 +27,14 @@ result_t die_s_nssai(dissector d, context* ctx, s_nssai_t* ret) {
         ret->mapped_hplmn_sd.present = true;
         de_fixed(d, ctx, ret->mapped_hplmn_sd.v).step(d);
     }
+    ret->id = intern_s_nssai(*ret);
     return {uc.consumed()};
 }
+
+uint16_t intern_s_nssai_octets(const octet_t& contents) {
+    if (contents.empty()) return 0;
+    s_nssai_t  v = {};
+    const auto n = int(contents.size());
+    die_s_nssai(dissector{nullptr, contents.data(), n, 0, n}, nullptr, &v);
+    return v.id;
+}
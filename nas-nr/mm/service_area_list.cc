@@ -28,7 +28,7 @@ result_t die_service_area_00(dissector d, context*ctx, service_area_00_t*ret){
 
     die_mcc_mnc(d, ctx, &ret->mccmnc).step(d);
 
-    for(auto i = 0; i <= ret->header.number; ++i){
+    for(auto i = 0; i <= ret->header.number && d.length > 0; ++i){
         tac_t v={};
         de_fixed(d, ctx, v.v).step(d);
         ret->tacs.push_back(v);
@@ -39,7 +39,7 @@ result_t die_service_area_00(dissector d, context*ctx, service_area_00_t*ret){
 result_t die_service_area_10(dissector d, context*ctx, service_area_10_t*ret){
     const use_context uc(&d, ctx, "service-area-10", 0);
     die_service_area_header(d, ctx, &ret->header).step(d);
-    for(auto i = 0; i<=ret->header.number;++i){
+    for(auto i = 0; i<=ret->header.number && d.length > 0;++i){
         service_area_10_t::area_t v = {};
         die_mcc_mnc(d, ctx, &v.mccmnc).step(d);
         de_fixed(d, ctx, v.tac.v).step(d);
@@ -59,7 +59,8 @@ result_t die_service_area_11(dissector d, context*ctx, service_area_11_t*ret){
 result_t die_service_area(dissector d, context*ctx, service_area_t*ret){
     const use_context uc(&d, ctx, "service-area", 0);
 
-    auto tl = umask(d.uint8(false), 0x60u);
+    auto tl   = umask(d.uint8(false), 0x60u);
+    ret->type = tl;
     switch (tl){
     case 0b00:
         ret->l_00 = std::make_shared<service_area_00_t>();
@@ -84,11 +85,11 @@ result_t die_service_area(dissector d, context*ctx, service_area_t*ret){
 }
 // 9.11.3.49    Service area list page.391
 result_t die_service_area_list(dissector d, context* ctx, service_area_list_t* ret) {
-    diag("de service-area-list not implemented yet");
+    const use_context uc(&d, ctx, "service-area-list", 0);
     while(d.length>0){
         service_area_t v = {};
-        die_service_area(d, ctx, &v).step(d);
+        if (die_service_area(d, ctx, &v).step(d) == 0) break;
         ret->partial.push_back(v);
     }
-    return {d.length};
+    return {uc.length};
 }
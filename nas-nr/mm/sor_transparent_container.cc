@@ -8,6 +8,7 @@ result_t die_sor_transparent_container(dissector                    d,
                                        sor_transparent_container_t* ret) {
     /* Layout differs depending on SOR data type*/
     const use_context uc(&d, ctx, "sor-transparent-container", 0);
+    de_uint8(d, ctx, &ret->header_octet);
     de_uint8(d, ctx, &ret->header.sor_data_type, 0x01u);
     de_uint8(d, ctx, &ret->header.list_ind, 0x02u);
     de_uint8(d, ctx, &ret->header.list_type, 0x04u);
@@ -22,7 +23,8 @@ result_t die_sor_transparent_container(dissector                    d,
     if (ret->header.list_type == 1) {
         ret->access_technology =
             std::make_shared< std::vector< sor_transparent_container_t::plmn_id_t > >();
-        for (auto i = ret->counter; i > 0; --i) {
+        // CounterSOR counts messages, not entries, the list fills the rest
+        while (d.length >= 5) {
             sor_transparent_container_t::plmn_id_t v = {};
             de_fixed(d, ctx, v.id).step(d);
             de_uint16(d, ctx, &v.access_technology_id).step(d);
@@ -0,0 +1,169 @@
+#include "../common/dissector.hh"
+#include "../common/messages.hh"
+#include "../common/ue_policy.hh"
+#include "../common/use_context.hh"
+
+namespace {
+/* D.6.2 UE policy section management list */
+void de_ue_policy_section_management_list(dissector                          d,
+                                          context*                           ctx,
+                                          std::vector< ue_policy_sublist_t >* ret) {
+    const use_context uc(&d, ctx, "ue-policy-section-management-list", 0);
+    while (d.length >= 2 + 3) {
+        const int l = d.uint16(true);
+        if (l < 3 || l > d.length) break;
+
+        auto s = d.slice(l);
+        d.step(l);
+
+        ue_policy_sublist_t sublist;
+        die_mcc_mnc(s.slice(3), ctx, &sublist.plmn).step(s);
+        while (s.length >= 2 + 2) {
+            const int il = s.uint16(true);
+            if (il < 2 || il > s.length) break;
+
+            ue_policy_instruction_t instruction;
+            instruction.upsc = s.uint16(true);
+            de_octet(s.slice(il - 2), ctx, &instruction.contents).step(s);
+            sublist.instructions.push_back(std::move(instruction));
+        }
+        ret->push_back(std::move(sublist));
+    }
+}
+
+/* D.6.3 UE policy section management result */
+void de_ue_policy_section_management_result(dissector                            d,
+                                            context*                             ctx,
+                                            std::vector< ue_policy_subresult_t >* ret) {
+    const use_context uc(&d, ctx, "ue-policy-section-management-result", 0);
+    while (d.length >= 1 + 3) {
+        const int n = d.uint8(true);
+
+        ue_policy_subresult_t subresult;
+        die_mcc_mnc(d.slice(3), ctx, &subresult.plmn).step(d);
+        for (auto i = 0; i < n && d.length >= 5; ++i) {
+            ue_policy_result_t r;
+            r.upsc                     = d.uint16(true);
+            r.failed_instruction_order = d.uint16(true);
+            r.cause                    = d.uint8(true);
+            subresult.results.push_back(r);
+        }
+        ret->push_back(std::move(subresult));
+    }
+}
+
+/* D.6.4 UPSI list */
+void de_upsi_list(dissector d, context* ctx, std::vector< upsi_sublist_t >* ret) {
+    const use_context uc(&d, ctx, "upsi-list", 0);
+    while (d.length >= 2 + 3) {
+        const int l = d.uint16(true);
+        if (l < 3 || l > d.length) break;
+
+        auto s = d.slice(l);
+        d.step(l);
+
+        upsi_sublist_t sublist;
+        die_mcc_mnc(s.slice(3), ctx, &sublist.plmn).step(s);
+        while (s.length >= 2) sublist.upscs.push_back(s.uint16(true));
+        ret->push_back(std::move(sublist));
+    }
+}
+
+// LV-E contents, clamped to what the message holds
+dissector le_contents(dissector* d) {
+    int l = d->uint16(true);
+    if (l > d->length) l = d->length;
+    auto s = d->slice(l);
+    d->step(l);
+    return s;
+}
+
+/* D.5.1 MANAGE UE POLICY COMMAND */
+result_t de_manage_ue_policy_command(dissector                   d,
+                                     context*                    ctx,
+                                     manage_ue_policy_command_t* ret) {
+    const use_context uc(&d, ctx, "manage-ue-policy-command", 0);
+    d.downlink();
+
+    ret->header.pti          = d.uint8(true);
+    ret->header.message_type = d.uint8(true);
+
+    // UE policy section management list	D.6.2	M	LV-E	11-65537
+    de_ue_policy_section_management_list(le_contents(&d), ctx, &ret->sections);
+
+    // 42	UE policy network classmark	D.6.7	O	TLV	3-5
+    de_tl_octet(d, ctx, 0x42, &ret->network_classmark).step(d);
+
+    return {uc.consumed()};
+}
+
+/* D.5.2 MANAGE UE POLICY COMPLETE */
+result_t de_manage_ue_policy_complete(dissector                    d,
+                                      context*                     ctx,
+                                      manage_ue_policy_complete_t* ret) {
+    const use_context uc(&d, ctx, "manage-ue-policy-complete", 0);
+    d.uplink();
+
+    ret->header.pti          = d.uint8(true);
+    ret->header.message_type = d.uint8(true);
+    return {uc.consumed()};
+}
+
+/* D.5.3 MANAGE UE POLICY COMMAND REJECT */
+result_t de_manage_ue_policy_command_reject(dissector                          d,
+                                           context*                           ctx,
+                                           manage_ue_policy_command_reject_t* ret) {
+    const use_context uc(&d, ctx, "manage-ue-policy-command-reject", 0);
+    d.uplink();
+
+    ret->header.pti          = d.uint8(true);
+    ret->header.message_type = d.uint8(true);
+
+    // UE policy section management result	D.6.3	M	LV-E	3-65537
+    de_ue_policy_section_management_result(le_contents(&d), ctx, &ret->results);
+    return {uc.consumed()};
+}
+
+/* D.5.4 UE STATE INDICATION */
+result_t de_ue_state_indication(dissector d, context* ctx, ue_state_indication_t* ret) {
+    const use_context uc(&d, ctx, "ue-state-indication", 0);
+    d.uplink();
+
+    ret->header.pti          = d.uint8(true);
+    ret->header.message_type = d.uint8(true);
+
+    // UPSI list	D.6.4	M	LV-E	9-65537
+    de_upsi_list(le_contents(&d), ctx, &ret->upsis);
+
+    // UE policy classmark	D.6.5	M	LV	2-4
+    de_l_octet(d, ctx, &ret->classmark).step(d);
+
+    // 41	UE OS Id	OS Id	D.6.6	O	TLV	18-242
+    de_tl_octet(d, ctx, 0x41, &ret->os_ids).step(d);
+    return {uc.consumed()};
+}
+} // namespace
+
+#define DISSECT(mt, X)                                 \
+    case mt:                                           \
+        ret->X = std::make_shared< X##_t >();          \
+        (void) de_##X(d, ctx, (ret->X).get()).step(d); \
+        break;
+
+/* D.5 UE policy delivery service messages */
+result_t de_updp_message(dissector d, context* ctx, updp_message_t* ret) {
+    const use_context uc(&d, ctx, "ue-policy-delivery-message", 0);
+
+    ret->header.pti          = d.uint8(false);
+    ret->header.message_type = d.uint8(false, 1);
+
+    switch (ret->header.message_type) {
+        DISSECT(0x01u, manage_ue_policy_command);
+        DISSECT(0x02u, manage_ue_policy_complete);
+        DISSECT(0x03u, manage_ue_policy_command_reject);
+        DISSECT(0x04u, ue_state_indication);
+    default:
+        break;
+    }
+    return {uc.length};
+}
@@ -1,5 +1,7 @@
 #include "../common/dissector.hh"
+#include "../common/intern.hh"
 #include "../common/messages.hh"
+#include "../common/payload_container.hh"
 #include "../common/use_context.hh"
 
 /* 8.2.10    UL NAS transport */
@@ -24,6 +26,7 @@ result_t de_ul_nas_transport(dissector d, context* ctx, ul_nas_transport_t* ret)
     // Spare half octet Spare half octet 9.5 M V 1 / 2
 
     // Payload container	Payload container	9.11.3.39	M	LV-E	3-65537
+    de_n1_sm_payload(d, ctx, ret->payload_container_type, &ret->n1_sm);
     de_le_octet(d, ctx, &ret->payload_container).step(d);
 
     // 12	PDU session ID	PDU session identity 2	9.11.3.41	C	TV	2
@@ -45,5 +48,9 @@ result_t de_ul_nas_transport(dissector d, context* ctx, ul_nas_transport_t* ret)
     de_tl_octet(d, ctx, 0x24, &ret->additional_information).step(d);
 
     // Z	MA PDU session information	MA PDU session information	O	TV	1
+
+    if (ret->s_nssai.present) ret->s_nssai_id = intern_s_nssai_octets(ret->s_nssai.v);
+    if (ret->dnn.present) ret->dnn_id = intern_dnn(ret->dnn.v);
+
     return {uc.consumed()};
 }
\ No newline at end of file
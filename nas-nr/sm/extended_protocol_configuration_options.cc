@@ -1,12 +1,24 @@
 #include "../common/dissector.hh"
+#include "../common/ies.hh"
+#include "../common/pco.hh"
 #include "../common/use_context.hh"
 
 // Extended protocol configuration options  9.11.4.6
 // See subclause 10.5.6.3A in 3GPP TS 24.008
-int dissect_extended_protocol_configuration_options(dissector d, context* ctx) {
+result_t die_extended_pco(dissector d, context* ctx, extended_pco_t* ret) {
     const use_context uc(&d, ctx, "extended-protocol-conf-options", -1);
 
     /* 1 ext 0 0 0 0 Spare  Configuration protocol */
+    de_uint8(d, ctx, &ret->ext, 0x80u);
+    de_uint8(d, ctx, &ret->configuration_protocol, 0x07u);
 
-    return uc.length;
+    auto            it = pco_options(d.safe_ptr(), d.safe_length(-1), true);
+    pco_option_view v;
+    while (it.next(&v)) {
+        extended_pco_t::option_t option;
+        option.id = v.id;
+        option.content.assign(v.value, v.value + v.length);
+        ret->options.push_back(std::move(option));
+    }
+    return {uc.length};
 }
@@ -1,27 +1,88 @@
+#include "../common/bit_rate.hh"
 #include "../common/dissector.hh"
 #include "../common/ies.hh"
 #include "../common/use_context.hh"
 
+namespace {
+uint8_t at(const octet_t& c, size_t i) { return i < c.size() ? c[i] : 0; }
+
+// 9.11.4.8 parameter contents into the record, a parameter too short is left out
+void decode_parameter(const mapped_eps_bearer_contexts_t::parameter_t& v,
+                      eps_bearer_record_t*                            r) {
+    namespace p  = mapped_eps_parameter;
+    const auto& c = v.content;
+    switch (v.id) {
+    case p::eps_qos:
+        // QCI, MBR and GBR octets, then their extended and extended-2 octets
+        if (c.empty()) return;
+        r->qci    = c[0];
+        r->mbr_ul = eps_bit_rate_bps(at(c, 1), at(c, 5), at(c, 9));
+        r->mbr_dl = eps_bit_rate_bps(at(c, 2), at(c, 6), at(c, 10));
+        r->gbr_ul = eps_bit_rate_bps(at(c, 3), at(c, 7), at(c, 11));
+        r->gbr_dl = eps_bit_rate_bps(at(c, 4), at(c, 8), at(c, 12));
+        break;
+    case p::extended_eps_qos:
+        // unit, MBR UL and DL, unit, GBR UL and DL; for rates past those of EPS QoS
+        if (c.size() < 10) return;
+        r->mbr_ul = eps_extended_bit_rate_bps(c[0], uint16_t(c[1] << 8u | c[2]));
+        r->mbr_dl = eps_extended_bit_rate_bps(c[0], uint16_t(c[3] << 8u | c[4]));
+        r->gbr_ul = eps_extended_bit_rate_bps(c[5], uint16_t(c[6] << 8u | c[7]));
+        r->gbr_dl = eps_extended_bit_rate_bps(c[5], uint16_t(c[8] << 8u | c[9]));
+        break;
+    case p::tft:
+        // TFT operation code, E bit, number of packet filters
+        if (c.empty()) return;
+        r->tft_opcode  = c[0] >> 5u;
+        r->tft_filters = c[0] & 0x0fu;
+        break;
+    case p::apn_ambr:
+        // downlink and uplink, then extended and extended-2 of each
+        if (c.size() < 2) return;
+        r->apn_ambr_dl = apn_ambr_bps(c[0], at(c, 2), at(c, 4));
+        r->apn_ambr_ul = apn_ambr_bps(c[1], at(c, 3), at(c, 5));
+        break;
+    case p::extended_ambr:
+        // unit and downlink, unit and uplink
+        if (c.size() < 6) return;
+        r->apn_ambr_dl = eps_extended_bit_rate_bps(c[0], uint16_t(c[1] << 8u | c[2]));
+        r->apn_ambr_ul = eps_extended_bit_rate_bps(c[3], uint16_t(c[4] << 8u | c[5]));
+        break;
+    default:
+        return;
+    }
+    r->present |= uint8_t(1u << v.id);
+}
+} // namespace
+
 // Mapped EPS  bearer contexts     9.11.4.8
 result_t die_mapped_eps_bearer_contexts(dissector                     d,
                                         context*                      ctx,
                                         mapped_eps_bearer_contexts_t* ret) {
     const use_context uc(&d, ctx, "mapped-eps-bearer-contexts", 0);
-    while(d.length>0){
+    while (d.length >= 3) {
         mapped_eps_bearer_contexts_t::context_t v = {};
-        de_uint8(d, ctx, &v.id).step(d);
-        auto l = d.uint8(true);
-        de_uint8(d, ctx, &v.parameters_n, 0x0fu);
-        de_uint8(d, ctx, &v.ebit, 0x10u);
-        de_uint8(d, ctx, &v.operation_code, 0xc0u).step(d);
+        de_uint8(d, ctx, &v.id, 0xf0u).step(d);
+        v.length = d.uint16(true);
+        if (v.length > d.length) break;
+
+        // the length covers the octet of operation code, E bit and number of parameters
+        auto b = d.slice(v.length);
+        d.step(v.length);
+        de_uint8(b, ctx, &v.parameters_n, 0x0fu);
+        de_uint8(b, ctx, &v.ebit, 0x10u);
+        de_uint8(b, ctx, &v.operation_code, 0xc0u).step(b);
 
-        for (auto i = 0; i < v.parameters_n;++i) {
+        v.record.ebi    = v.id;
+        v.record.opcode = v.operation_code;
+        for (auto i = 0; i < v.parameters_n && b.length >= 2; ++i) {
             mapped_eps_bearer_contexts_t::parameter_t p = {};
-            de_uint8(d, ctx, &p.id).step(d);
-            de_l_octet(d, ctx, &p.content).step(d);
-            v.parameters.push_back(p);
+            de_uint8(b, ctx, &p.id).step(b);
+            if (b.uint8(false) > b.length - 1) break;
+            de_l_octet(b, ctx, &p.content).step(b);
+            decode_parameter(p, &v.record);
+            v.parameters.push_back(std::move(p));
         }
-        ret->contexts.push_back(v);
+        ret->contexts.push_back(std::move(v));
     }
     return {uc.length};
 }
@@ -1,4 +1,5 @@
 #include "../common/dissector.hh"
+#include "../common/intern.hh"
 #include "../common/messages.hh"
 #include "../common/use_context.hh"
 
@@ -67,5 +68,8 @@ result_t de_pdu_session_establishment_accept(dissector
     // TBD	Serving PLMN rate control Serving PLMN rate control	9.11.4.20	O	TLV	4
     // XX	ATSSS container	ATSSS container	9.11.4.22	O	TLV-E	3-65538
     // XX	Control plane only indication	9.11.4.23	O	TV	1
+    if (ret->s_nssai.present) ret->s_nssai_id = intern_s_nssai_octets(ret->s_nssai.v);
+    if (ret->dnn.present) ret->dnn_id = intern_dnn(ret->dnn.v);
+
     return {uc.consumed()};
 }
\ No newline at end of file
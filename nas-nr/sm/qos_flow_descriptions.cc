@@ -1,30 +1,75 @@
+#include "../common/bit_rate.hh"
 #include "../common/dissector.hh"
 #include "../common/ies.hh"
 #include "../common/use_context.hh"
 
+namespace {
+// 9.11.4.12 parameter contents into the record, a parameter too short is left out
+void decode_parameter(const qos_flow_descriptions_t::parameter_t& v, qos_flow_record_t* r) {
+    namespace p  = qos_flow_parameter;
+    const auto* c = v.content.data();
+    const auto  l = v.content.size();
+    switch (v.id) {
+    case p::five_qi:
+        if (l < 1) return;
+        r->five_qi = c[0];
+        break;
+    case p::gfbr_ul:
+    case p::gfbr_dl:
+    case p::mfbr_ul:
+    case p::mfbr_dl: {
+        if (l < 3) return;
+        const auto bps = nr_bit_rate_bps(c[0], uint16_t(c[1] << 8u | c[2]));
+        if (v.id == p::gfbr_ul) r->gfbr_ul = bps;
+        if (v.id == p::gfbr_dl) r->gfbr_dl = bps;
+        if (v.id == p::mfbr_ul) r->mfbr_ul = bps;
+        if (v.id == p::mfbr_dl) r->mfbr_dl = bps;
+        break;
+    }
+    case p::averaging_window:
+        if (l < 2) return;
+        r->averaging_window = uint32_t(c[0] << 8u | c[1]);
+        break;
+    case p::eps_bearer_id:
+        if (l < 1) return;
+        r->ebi = c[0] >> 4u;
+        break;
+    default:
+        return;
+    }
+    r->present |= uint16_t(1u << v.id);
+}
+} // namespace
+
 // Authorized QoS flow descriptions     QoS flow descriptions 9.11.4.12
 result_t die_qos_flow_description(dissector                         d,
                                   context*                          ctx,
                                   qos_flow_descriptions_t::entry_t* ret) {
-    const use_context uc(&d, ctx, "qos-flow-description", 0);
+    const use_context uc(&d, ctx, "qos-flow-description", -1);
     de_uint8(d, ctx, &ret->qfi, 0x3fu).step(d);
-    de_uint8(d, ctx, &ret->opcode, 0xc0u).step(d);
+    de_uint8(d, ctx, &ret->opcode, 0xe0u).step(d);
     de_uint8(d, ctx, &ret->ebit, 0x40u);
     auto n = d.uint8(true) & 0x3fu;
-    for (auto i = 0; i < n; ++i) {
+
+    ret->record.qfi    = ret->qfi;
+    ret->record.opcode = ret->opcode;
+    for (auto i = 0; i < n && d.length >= 2; ++i) {
         qos_flow_descriptions_t::parameter_t v = {};
         de_uint8(d, ctx, &v.id).step(d);
-        de_l_octet(d, ctx, &v.content);
-        ret->parameters.push_back(v);
+        if (d.uint8(false) > d.length - 1) break;
+        de_l_octet(d, ctx, &v.content).step(d);
+        decode_parameter(v, &ret->record);
+        ret->parameters.push_back(std::move(v));
     }
     return {uc.consumed()};
 }
-result_t dei_qos_flow_descriptions(dissector d, context* ctx, qos_flow_descriptions_t*ret){
+
+result_t die_qos_flow_descriptions(dissector d, context* ctx, qos_flow_descriptions_t* ret) {
     const use_context uc(&d, ctx, "qos-flow-descriptions", 0);
-    while(d.length> 0 ){
+    while (d.length >= 3) {
         qos_flow_descriptions_t::entry_t v = {};
         die_qos_flow_description(d, ctx, &v).step(d);
-        ret->descs.push_back(v);
+        ret->descs.push_back(std::move(v));
     }
     return {uc.length};
-}
\ No newline at end of file
+}
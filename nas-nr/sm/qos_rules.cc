@@ -1,3 +1,6 @@
+#include <algorithm>
+
+#include "../common/core.hh"
 #include "../common/dissector.hh"
 #include "../common/ies.hh"
 #include "../common/use_context.hh"
@@ -5,17 +8,96 @@
 /*The description and valid combinations of packet filter component type identifiers in a
  * packet filter are defined in 3GPP TS 23.501 [8].*/
 
+namespace {
+uint32_t de_be(dissector& d, int n) {
+    uint32_t v = 0;
+    for (auto i = 0; i < n; ++i) v = v << 8u | d.uint8(true);
+    return v;
+}
+} // namespace
+
+// Table 9.11.4.13.1 packet filter contents, a list of type identifier and value pairs
+result_t die_packet_filter_components(dissector                   d,
+                                      context*                    ctx,
+                                      packet_filter_components_t* ret) {
+    const use_context uc(&d, ctx, "packet-filter-components", 0);
+    namespace pfc = packet_filter_component;
+
+    // component lengths are implied by the type, a truncated one ends the list
+    auto need = [&d](int n) { return d.length >= n; };
+    while (d.length > 0) {
+        const auto type = d.uint8(true);
+        if (type == pfc::match_all) {
+            ret->match_all = 1;
+        } else if ((type == pfc::ipv4_remote || type == pfc::ipv4_local) && need(8)) {
+            auto& v = type == pfc::ipv4_remote ? ret->ipv4_remote : ret->ipv4_local;
+            v.present = true;
+            d.octet(v.v.address, 4);
+            d.octet(v.v.mask, 4);
+        } else if ((type == pfc::ipv6_remote || type == pfc::ipv6_local) && need(17)) {
+            auto& v = type == pfc::ipv6_remote ? ret->ipv6_remote : ret->ipv6_local;
+            v.present = true;
+            d.octet(v.v.address, 16);
+            v.v.prefix_length = d.uint8(true);
+        } else if (type == pfc::protocol && need(1)) {
+            ret->protocol = {true, d.uint8(true)};
+        } else if ((type == pfc::local_port || type == pfc::remote_port) && need(2)) {
+            auto& v = type == pfc::local_port ? ret->local_port : ret->remote_port;
+            v.present = true;
+            v.v.low = v.v.high = d.uint16(true);
+        } else if ((type == pfc::local_port_range || type == pfc::remote_port_range) &&
+                   need(4)) {
+            auto& v = type == pfc::local_port_range ? ret->local_port : ret->remote_port;
+            v.present = true;
+            v.v.low   = d.uint16(true);
+            v.v.high  = d.uint16(true);
+        } else if (type == pfc::spi && need(4)) {
+            ret->spi = {true, de_be(d, 4)};
+        } else if (type == pfc::tos && need(2)) {
+            ret->tos.present = true;
+            ret->tos.v.value = d.uint8(true);
+            ret->tos.v.mask  = d.uint8(true);
+        } else if (type == pfc::flow_label && need(3)) {
+            ret->flow_label = {true, de_be(d, 3) & 0xfffffu};
+        } else if ((type == pfc::dst_mac || type == pfc::src_mac) && need(6)) {
+            auto& v = type == pfc::dst_mac ? ret->dst_mac : ret->src_mac;
+            v.present = true;
+            d.octet(v.v.low, 6);
+            std::copy(std::begin(v.v.low), std::end(v.v.low), std::begin(v.v.high));
+        } else if ((type == pfc::dst_mac_range || type == pfc::src_mac_range) &&
+                   need(12)) {
+            auto& v = type == pfc::dst_mac_range ? ret->dst_mac : ret->src_mac;
+            v.present = true;
+            d.octet(v.v.low, 6);
+            d.octet(v.v.high, 6);
+        } else if ((type == pfc::ctag_vid || type == pfc::stag_vid) && need(2)) {
+            auto& v = type == pfc::ctag_vid ? ret->ctag_vid : ret->stag_vid;
+            v = {true, uint16_t(d.uint16(true) & 0x0fffu)};
+        } else if ((type == pfc::ctag_pcp_dei || type == pfc::stag_pcp_dei) && need(1)) {
+            auto& v = type == pfc::ctag_pcp_dei ? ret->ctag_pcp_dei : ret->stag_pcp_dei;
+            v = {true, uint8_t(d.uint8(true) & 0x0fu)};
+        } else if (type == pfc::ethertype && need(2)) {
+            ret->ethertype = {true, d.uint16(true)};
+        } else {
+            // unknown or truncated, the length of what follows is not known
+            ret->unknown_type = type;
+            diag("unknown packet filter component type %d\n", type);
+            d.step(d.length);
+        }
+    }
+    return {uc.length};
+}
+
 // Figure 9.11.4.13.4 Packet filter list when the rule operation is "create new QoS rule",
 // or "modify existing QoS rule and add packet filters" or "modify existing QoS rule and
 // replace all packet filters"
 
-
 // Authorized QoS rules QoS rules 9.11.4.13
 result_t die_qos_rule(dissector d, context* ctx, qos_rule_t*ret){
     const use_context uc(&d, ctx, "qos-rule", 0);
     de_nibble(d, ctx, &ret->packet_filters_n);
     de_uint8(d, ctx, &ret->dqr, 0x10u);
-    de_uint8(d, ctx, &ret->rule_operation_code, 0xc0u).step(d);
+    de_uint8(d, ctx, &ret->rule_operation_code, 0xe0u).step(d);
 
     switch (ret->rule_operation_code) {
     case 0b000:
@@ -23,19 +105,23 @@ result_t die_qos_rule(dissector d, context* ctx, qos_rule_t*ret){
     case 0b001: // create new QoS rule
     case 0b011: // Modify existing QoS rule and add packet filter
     case 0b100: { // Modify existing QoS rule and replace
-        qos_rule_t::packet_filter_add_t v = {};
-        for (auto i = 0; i < ret->packet_filters_n; ++i) {
+        for (auto i = 0; i < ret->packet_filters_n && d.length > 0; ++i) {
+            qos_rule_t::packet_filter_add_t v = {};
             de_uint8(d, ctx, &v.id, 0x0fu);
             de_uint8(d, ctx, &v.direction, 0x30u).step(d);
+            // a length past the rule would read beyond the buffer, the slice is not bounded
+            const auto length   = 1 + d.uint8(false);
+            auto       contents = d.slice(length > d.length ? d.length : length);
+            die_packet_filter_components(contents.step(1), ctx, &v.components);
             de_l_octet(d, ctx, &v.content).step(d);
+            ret->add_packets.push_back(v);
         }
-        ret->add_packets.push_back(v);
     }
         break; //
     case 0b010:     // Delete existing QoS rule
         break;  //
     case 0b101: // Modify existing QoS rule and delete
-        for (auto i = 0; i < ret->packet_filters_n;++i) {
+        for (auto i = 0; i < ret->packet_filters_n && d.length > 0; ++i) {
             auto id = d.uint8(true) & 0x0fu;
             ret->delete_packets.push_back(id);
         }
@@ -59,10 +145,11 @@ result_t die_qos_rules(dissector d, context* ctx, qos_rules_t*ret){
     const use_context uc(&d, ctx, "qos-rules", 0);
     while(d.length> 0 ){
         qos_rule_t v = {};
-        v.id      = d.uint8(true);
-        v.length       = d.uint8(true);
+        v.id     = d.uint8(true);
+        v.length = d.uint16(true); // 2 octets, Figure 9.11.4.13.2
+        if (v.length > d.length) break; // truncated, the rest is not a rule
         die_qos_rule(d.slice(v.length), ctx, &v).step(d);
         ret->rules.push_back(v);
     }
     return {uc.length};
-}
\ No newline at end of file
+}
@@ -1,18 +1,22 @@
+#include "../common/bit_rate.hh"
 #include "../common/dissector.hh"
 #include "../common/ies.hh"
 #include "../common/use_context.hh"
 
-// 9.11.4.14    Session-AMBR
+// 9.11.4.19    Session-TMBR
 result_t die_session_tmbr(dissector d, context* ctx, session_tmbr_t*ret){
     const use_context uc(&d, ctx, "session-tmbr", 0);
     ret->downlink_unit = d.uint8(true);
     ret->downlink      = d.uint16(true);
     ret->uplink_unit   = d.uint8(true);
     ret->uplink        = d.uint16(true);
+    ret->downlink_bps  = nr_bit_rate_bps(ret->downlink_unit, ret->downlink);
+    ret->uplink_bps    = nr_bit_rate_bps(ret->uplink_unit, ret->uplink);
 
     return {6};
 }
 
+// 9.11.4.14    Session-AMBR
 result_t die_session_ambr(dissector d, context* ctx, session_ambr_t*ret){
     const use_context uc(&d, ctx, "session-ambr", 0);
 
@@ -20,5 +24,13 @@ result_t die_session_ambr(dissector d, context* ctx, session_ambr_t*ret){
     ret->downlink      = d.uint16(true);
     ret->uplink_unit   = d.uint8(true);
     ret->uplink        = d.uint16(true);
+    ret->downlink_bps  = nr_bit_rate_bps(ret->downlink_unit, ret->downlink);
+    ret->uplink_bps    = nr_bit_rate_bps(ret->uplink_unit, ret->uplink);
     return {6};
-}
\ No newline at end of file
+}
+
+session_ambr_t session_ambr(const octet_6& contents) {
+    session_ambr_t ret;
+    (void) die_session_ambr(dissector{nullptr, contents, 6, 0, 6}, nullptr, &ret);
+    return ret;
+}
@@ -27,6 +27,7 @@
 
 #include "secu_defs.h"
 #include "security_types.h"
+#include "sha256_mb.h"
 
 void kdf(const uint8_t *key,
          const unsigned key_len,
@@ -59,3 +60,84 @@ int derive_keNB(const uint8_t *kasme_32, const uint32_t nas_count, uint8_t *keNB
     kdf(kasme_32, 32, s, 7, keNB, 32);
     return 0;
 }
+
+/* HMAC (RFC 2104) inner message: (K ^ ipad) || S, padded to whole blocks */
+static unsigned kdf_pad_inner(const kdf_job_t *job, uint8_t *buf) {
+    const unsigned len     = SHA256_BLOCK_SIZE + job->s_len;
+    const unsigned nblocks = (len + 9 + SHA256_BLOCK_SIZE - 1) / SHA256_BLOCK_SIZE;
+    const uint64_t bits    = (uint64_t) len << 3u;
+    unsigned       i;
+
+    memset(buf, 0, nblocks * SHA256_BLOCK_SIZE);
+    memcpy(buf, job->key, job->key_len);
+    for (i = 0; i < SHA256_BLOCK_SIZE; i++) buf[i] ^= 0x36;
+    memcpy(buf + SHA256_BLOCK_SIZE, job->s, job->s_len);
+    buf[len] = 0x80;
+    for (i = 0; i < 8; i++) buf[nblocks * SHA256_BLOCK_SIZE - 1 - i] = (uint8_t)(bits >> (8 * i));
+    return nblocks;
+}
+
+/* HMAC outer message: (K ^ opad) || H(inner), always two blocks */
+static unsigned kdf_pad_outer(const kdf_job_t *job, const sha256_state_t *inner, uint8_t *buf) {
+    unsigned i;
+
+    memset(buf, 0, 2 * SHA256_BLOCK_SIZE);
+    memcpy(buf, job->key, job->key_len);
+    for (i = 0; i < SHA256_BLOCK_SIZE; i++) buf[i] ^= 0x5c;
+    sha256_state_digest(inner, buf + SHA256_BLOCK_SIZE, SHA256_DIGEST_SIZE);
+    buf[SHA256_BLOCK_SIZE + SHA256_DIGEST_SIZE] = 0x80;
+    buf[2 * SHA256_BLOCK_SIZE - 2]              = 0x03; /* (64 + 32) * 8 = 0x300 bits */
+    return 2;
+}
+
+static int kdf_job_batchable(const kdf_job_t *job) {
+    return job->key_len <= SHA256_BLOCK_SIZE && job->s_len <= KDF_BATCH_MAX_S_LEN &&
+           job->out_len <= SHA256_DIGEST_SIZE;
+}
+
+/* derive every job queued in lane_jobs with two multi-buffer passes */
+static void kdf_batch_flush(kdf_job_t **lane_jobs, const unsigned lanes) {
+    uint8_t         inner[SHA256_MB_LANES][KDF_BATCH_MAX_BLOCKS * SHA256_BLOCK_SIZE];
+    uint8_t         outer[SHA256_MB_LANES][2 * SHA256_BLOCK_SIZE];
+    const uint8_t * blocks[SHA256_MB_LANES];
+    unsigned        nblocks[SHA256_MB_LANES];
+    sha256_state_t  states[SHA256_MB_LANES];
+    unsigned        l;
+
+    for (l = 0; l < lanes; l++) {
+        sha256_state_init(&states[l]);
+        nblocks[l] = kdf_pad_inner(lane_jobs[l], inner[l]);
+        blocks[l]  = inner[l];
+    }
+    sha256_mb_compress(states, blocks, nblocks, lanes);
+
+    for (l = 0; l < lanes; l++) {
+        nblocks[l] = kdf_pad_outer(lane_jobs[l], &states[l], outer[l]);
+        blocks[l]  = outer[l];
+        sha256_state_init(&states[l]);
+    }
+    sha256_mb_compress(states, blocks, nblocks, lanes);
+
+    for (l = 0; l < lanes; l++)
+        sha256_state_digest(&states[l], lane_jobs[l]->out, lane_jobs[l]->out_len);
+}
+
+void kdf_batch(kdf_job_t *jobs, const unsigned n) {
+    kdf_job_t *lane_jobs[SHA256_MB_LANES];
+    unsigned   i, lanes = 0;
+    const int  wide = n > 1 && sha256_mb_wide();
+
+    for (i = 0; i < n; i++) {
+        kdf_job_t *job = &jobs[i];
+        if (!wide || !kdf_job_batchable(job)) {
+            kdf(job->key, job->key_len, (uint8_t *) job->s, job->s_len, job->out, job->out_len);
+            continue;
+        }
+        lane_jobs[lanes++] = job;
+        if (lanes == SHA256_MB_LANES) {
+            kdf_batch_flush(lane_jobs, lanes);
+            lanes = 0;
+        }
+    }
+    if (lanes > 0) kdf_batch_flush(lane_jobs, lanes);
+}
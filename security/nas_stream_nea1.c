@@ -31,22 +31,18 @@
 #include "secu_defs.h"
 #include "snow3g.h"
 
-inline uint32_t hton_int32(uint32_t x){
-    return (((x & 0x000000FFu) << 24u) | ((x & 0x0000FF00u) << 8u) |  ((x & 0x00FF0000u) >> 8u) | ((x & 0xFF000000u) >> 24u));
-}
 int nas_stream_encrypt_nea1(nas_stream_cipher_t *const stream_cipher,
                             uint8_t *const             out) {
     snow_3g_context_t snow_3g_context;
     int               n;
     int               i        = 0;
     uint32_t          zero_bit = 0;
-    // uint32_t                                byte_length;
+    uint32_t  byte_length;
     uint32_t *KS;
     uint32_t  K[4], IV[4];
 
     n        = (int)(stream_cipher->blength + 31u) / 32;
     zero_bit = stream_cipher->blength & 0x7u;
-    // byte_length = stream_cipher->blength >> 3;
     memset(&snow_3g_context, 0, sizeof(snow_3g_context));
     /*
      * Initialisation
@@ -88,36 +84,23 @@ int nas_stream_encrypt_nea1(nas_stream_cipher_t *const stream_cipher,
     KS = (uint32_t *) malloc(4 * n);
     snow3g_generate_key_stream(n, (uint32_t *) KS, &snow_3g_context);
 
-    if (zero_bit > 0) {
-        KS[n - 1] = KS[n - 1] & (uint32_t)(0xFFFFFFFF << (8 - zero_bit));
-    }
-
     for (i = 0; i < n; i++) {
         KS[i] = hton_int32(KS[i]);
     }
 
     /*
      * Exclusive-OR the input data with keystream to generate the output bit
-     * stream
+     * stream, touching only the (blength + 7) / 8 octets both buffers hold
      */
-    for (i = 0; i < n * 4; i++) {
-        stream_cipher->message[i] ^= *(((uint8_t *) KS) + i);
+    byte_length = (stream_cipher->blength + 7u) >> 3u;
+    for (i = 0; i < (int) byte_length; i++) {
+        out[i] = stream_cipher->message[i] ^ *(((uint8_t *) KS) + i);
     }
 
-    int ceil_index = 0;
-
     if (zero_bit > 0) {
-        ceil_index = (int)((stream_cipher->blength + 7u) >> 3u);
-        stream_cipher->message[ceil_index - 1] =
-            stream_cipher->message[ceil_index - 1] & (uint8_t)(0xFFu << (8 - zero_bit));
+        out[byte_length - 1] &= (uint8_t)(0xFFu << (8 - zero_bit));
     }
 
     free((void *) KS);
-    memcpy(out, stream_cipher->message, n * 4);
-
-    if (zero_bit > 0) {
-        out[ceil_index - 1] = stream_cipher->message[ceil_index - 1];
-    }
-
     return 0;
 }
@@ -38,8 +38,8 @@ int nas_stream_encrypt_nea2(nas_stream_cipher_t *const stream_cipher,
     uint32_t zero_bit = 0;
     uint32_t byte_length;
 
-    DevAssert(stream_cipher != NULL);
-    DevAssert(out != NULL);
+    if (stream_cipher == NULL || out == NULL) return -1;
+
     zero_bit    = stream_cipher->blength & 0x7;
     byte_length = stream_cipher->blength >> 3;
 
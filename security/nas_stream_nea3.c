@@ -0,0 +1,40 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "secu_defs.h"
+#include "zuc.h"
+
+/* 128-NEA3, TS 33.501 D.2.3 (128-EEA3 of TS 33.401 B.1.4) */
+int nas_stream_encrypt_nea3(nas_stream_cipher_t *const stream_cipher,
+                            uint8_t *const             out) {
+    uint8_t   iv[16];
+    uint32_t *ks;
+    uint32_t  n, i, byte_length, zero_bit;
+
+    if (stream_cipher == NULL || out == NULL) return -1;
+
+    n           = (stream_cipher->blength + 31u) / 32u;
+    byte_length = (stream_cipher->blength + 7u) >> 3u;
+    zero_bit    = stream_cipher->blength & 0x7u;
+
+    iv[0] = (uint8_t)(stream_cipher->count >> 24u);
+    iv[1] = (uint8_t)(stream_cipher->count >> 16u);
+    iv[2] = (uint8_t)(stream_cipher->count >> 8u);
+    iv[3] = (uint8_t)(stream_cipher->count);
+    iv[4] = (uint8_t)(((stream_cipher->bearer & 0x1Fu) << 3u) |
+                      ((stream_cipher->direction & 0x01u) << 2u));
+    iv[5] = iv[6] = iv[7] = 0;
+    memcpy(&iv[8], &iv[0], 8);
+
+    ks = (uint32_t *) malloc(4 * (n ? n : 1));
+    ZUC(stream_cipher->key, iv, ks, (int) n);
+
+    for (i = 0; i < byte_length; i++) {
+        out[i] = stream_cipher->message[i] ^ (uint8_t)(ks[i / 4] >> (24u - 8u * (i % 4)));
+    }
+    if (zero_bit > 0) out[byte_length - 1] &= (uint8_t)(0xFFu << (8 - zero_bit));
+
+    free(ks);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "secu_defs.h"
+#include "snow3g.h"
+
+/* V * 2 in GF(2^64) reduced by c, UIA2 specification 4.3 */
+static uint64_t nia1_mul64x(uint64_t v, uint64_t c) {
+    return (v & 0x8000000000000000ULL) ? (v << 1u) ^ c : v << 1u;
+}
+
+/* V * P in GF(2^64), UIA2 specification 4.3 */
+static uint64_t nia1_mul64(uint64_t v, uint64_t p, uint64_t c) {
+    uint64_t result = 0;
+    int      i;
+
+    for (i = 0; i < 64; i++) {
+        if ((p >> i) & 0x1u) result ^= v;
+        v = nia1_mul64x(v, c);
+    }
+    return result;
+}
+
+/* 64 message bits from octet offset, zero filled past the end */
+static uint64_t nia1_block(const uint8_t *m, uint32_t offset, uint32_t byte_length) {
+    uint64_t v = 0;
+    uint32_t i;
+
+    for (i = 0; i < 8; i++) {
+        v <<= 8u;
+        if (offset + i < byte_length) v |= m[offset + i];
+    }
+    return v;
+}
+
+/* 128-NIA1, TS 33.501 D.3.1 (128-EIA1 of TS 33.401 B.2.2): UIA2 with
+ * COUNT-I = COUNT and FRESH = BEARER << 27 */
+int nas_stream_encrypt_nia1(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]) {
+    snow_3g_context_t snow_3g_context;
+    uint32_t          K[4], IV[4], z[5];
+    uint32_t          fresh, d, i, byte_length, zero_bit;
+    uint64_t          p, q, eval = 0, block;
+    uint32_t          mac;
+
+    if (stream_cipher == NULL || out == NULL) return -1;
+
+    for (i = 0; i < 4; i++) {
+        memcpy(&K[3 - i], stream_cipher->key + 4 * i, 4);
+        K[3 - i] = hton_int32(K[3 - i]);
+    }
+
+    fresh = ((uint32_t) stream_cipher->bearer & 0x1Fu) << 27u;
+    IV[3] = stream_cipher->count;
+    IV[2] = fresh;
+    IV[1] = ((uint32_t)(stream_cipher->direction & 0x1u) << 31u) ^ stream_cipher->count;
+    IV[0] = fresh ^ ((uint32_t)(stream_cipher->direction & 0x1u) << 15u);
+
+    memset(&snow_3g_context, 0, sizeof(snow_3g_context));
+    snow3g_initialize(K, IV, &snow_3g_context);
+    snow3g_generate_key_stream(5, z, &snow_3g_context);
+
+    p = (uint64_t) z[0] << 32u | z[1];
+    q = (uint64_t) z[2] << 32u | z[3];
+
+    byte_length = (stream_cipher->blength + 7u) >> 3u;
+    zero_bit    = stream_cipher->blength & 0x7u;
+    d           = (stream_cipher->blength + 63u) / 64u;
+    for (i = 0; i < d; i++) {
+        block = nia1_block(stream_cipher->message, 8 * i, byte_length);
+        if (i + 1 == d && zero_bit > 0) {
+            /* clear the bits past blength in its final octet */
+            const uint32_t last = (byte_length - 1) - 8 * i;
+            block &= ~((uint64_t)(0xFFu >> zero_bit) << (8u * (7u - last)));
+        }
+        eval = nia1_mul64(eval ^ block, p, 0x1bULL);
+    }
+    eval ^= stream_cipher->blength;
+    eval = nia1_mul64(eval, q, 0x1bULL);
+
+    mac    = (uint32_t)(eval >> 32u) ^ z[4];
+    out[0] = (uint8_t)(mac >> 24u);
+    out[1] = (uint8_t)(mac >> 16u);
+    out[2] = (uint8_t)(mac >> 8u);
+    out[3] = (uint8_t)(mac);
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nettle/aes.h>
+
+#include "secu_defs.h"
+
+/* doubling in GF(2^128) for the CMAC subkeys, RFC 4493 2.3 */
+static void nia2_dbl(const uint8_t in[16], uint8_t out[16]) {
+    const uint8_t carry = in[0] >> 7u;
+    int           i;
+
+    for (i = 0; i < 15; i++) out[i] = (uint8_t)(in[i] << 1u | in[i + 1] >> 7u);
+    out[15] = (uint8_t)(in[15] << 1u) ^ (uint8_t)(carry ? 0x87 : 0);
+}
+
+/* 128-NIA2, TS 33.501 D.3.2 (128-EIA2 of TS 33.401 B.2.3): AES-CMAC over
+ * COUNT || BEARER || DIRECTION || 0^26 || MESSAGE, with bit granular padding */
+int nas_stream_encrypt_nia2(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]) {
+    struct aes128_ctx ctx;
+    uint8_t           l[16] = {0}, k1[16], k2[16], x[16] = {0}, block[16];
+    uint8_t *         m;
+    uint32_t          bits, len, nblocks, i, j;
+    const uint8_t *   last_key;
+
+    if (stream_cipher == NULL || out == NULL) return -1;
+
+    bits = 64u + stream_cipher->blength;
+    len  = (bits + 7u) / 8u;
+    m    = (uint8_t *) calloc(len + 16u, 1);
+
+    m[0] = (uint8_t)(stream_cipher->count >> 24u);
+    m[1] = (uint8_t)(stream_cipher->count >> 16u);
+    m[2] = (uint8_t)(stream_cipher->count >> 8u);
+    m[3] = (uint8_t)(stream_cipher->count);
+    m[4] = (uint8_t)(((stream_cipher->bearer & 0x1Fu) << 3u) |
+                     ((stream_cipher->direction & 0x01u) << 2u));
+    memcpy(&m[8], stream_cipher->message, (stream_cipher->blength + 7u) / 8u);
+    if (bits % 8u) m[len - 1] &= (uint8_t)(0xFFu << (8u - bits % 8u));
+
+    aes128_set_encrypt_key(&ctx, stream_cipher->key);
+    aes128_encrypt(&ctx, 16, l, l);
+    nia2_dbl(l, k1);
+    nia2_dbl(k1, k2);
+
+    nblocks = (bits + 127u) / 128u;
+    if (bits % 128u == 0) {
+        last_key = k1;
+    } else {
+        /* append a single 1 bit, the zeros are already there */
+        m[bits / 8u] |= (uint8_t)(0x80u >> (bits % 8u));
+        last_key = k2;
+    }
+
+    for (i = 0; i < nblocks; i++) {
+        for (j = 0; j < 16; j++) block[j] = x[j] ^ m[16 * i + j];
+        if (i + 1 == nblocks)
+            for (j = 0; j < 16; j++) block[j] ^= last_key[j];
+        aes128_encrypt(&ctx, 16, x, block);
+    }
+    free(m);
+
+    memcpy(out, x, 4);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "secu_defs.h"
+#include "zuc.h"
+
+/* 32 bits of keystream starting at bit i */
+static uint32_t nia3_word(const uint32_t *ks, uint32_t i) {
+    const uint32_t j = i / 32u, k = i % 32u;
+    return k == 0 ? ks[j] : (ks[j] << k) | (ks[j + 1] >> (32u - k));
+}
+
+/* 128-NIA3, TS 33.501 D.3.3 (128-EIA3 of TS 33.401 B.2.3) */
+int nas_stream_encrypt_nia3(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]) {
+    uint8_t   iv[16];
+    uint32_t *ks;
+    uint32_t  n, i, t = 0, mac;
+
+    if (stream_cipher == NULL || out == NULL) return -1;
+
+    iv[0]  = (uint8_t)(stream_cipher->count >> 24u);
+    iv[1]  = (uint8_t)(stream_cipher->count >> 16u);
+    iv[2]  = (uint8_t)(stream_cipher->count >> 8u);
+    iv[3]  = (uint8_t)(stream_cipher->count);
+    iv[4]  = (uint8_t)((stream_cipher->bearer & 0x1Fu) << 3u);
+    iv[5]  = iv[6] = iv[7] = 0;
+    memcpy(&iv[8], &iv[0], 8);
+    iv[8]  ^= (uint8_t)((stream_cipher->direction & 0x01u) << 7u);
+    iv[14] ^= (uint8_t)((stream_cipher->direction & 0x01u) << 7u);
+
+    n  = (stream_cipher->blength + 31u) / 32u + 2u;
+    ks = (uint32_t *) malloc(4 * n);
+    ZUC(stream_cipher->key, iv, ks, (int) n);
+
+    for (i = 0; i < stream_cipher->blength; i++) {
+        if (stream_cipher->message[i / 8] & (0x80u >> (i % 8))) t ^= nia3_word(ks, i);
+    }
+    t ^= nia3_word(ks, stream_cipher->blength);
+    mac = t ^ ks[n - 1];
+    free(ks);
+
+    out[0] = (uint8_t)(mac >> 24u);
+    out[1] = (uint8_t)(mac >> 16u);
+    out[2] = (uint8_t)(mac >> 8u);
+    out[3] = (uint8_t)(mac);
+    return 0;
+}
@@ -0,0 +1,319 @@
+/* Conformance and throughput harness for the NAS security algorithms.
+ *
+ * Every run first checks each algorithm against the TS 33.501 / TS 33.401
+ * Annex C (TS 35.2xx) test sets and RFC 4231 for the HMAC-SHA-256 KDF, and
+ * stops on the first mismatch. It then measures messages per second and
+ * cycles per byte for message sizes from 3 bytes to 9 KB.
+ *
+ *   secu-bench [min_ms_per_point]
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SECU_BENCH_TSC 1
+#endif
+
+#include "secu_defs.h"
+
+typedef int (*stream_fn_t)(nas_stream_cipher_t *const stream_cipher, uint8_t *const out);
+
+typedef struct {
+    const char *name;
+    stream_fn_t fn;
+} secu_algorithm_t;
+
+typedef struct {
+    const char *set;
+    const char *algorithm;
+    const char *key;
+    uint32_t    count;
+    uint8_t     bearer;
+    uint8_t     direction;
+    uint32_t    blength;
+    const char *message;
+    const char *expected;
+} secu_vector_t;
+
+static const secu_algorithm_t algorithms[] = {
+    {"128-NEA1", nas_stream_encrypt_nea1},
+    {"128-NEA2", nas_stream_encrypt_nea2},
+    {"128-NEA3", nas_stream_encrypt_nea3},
+    {"128-NIA1", nas_stream_encrypt_nia1},
+    {"128-NIA2", nas_stream_encrypt_nia2},
+    {"128-NIA3", nas_stream_encrypt_nia3},
+};
+
+/* TS 33.401 Annex C, the 128-NxA sets of TS 33.501 Annex D reuse them */
+static const secu_vector_t vectors[] = {
+    {"C.1 set 1", "128-NEA1", "d3c5d592327fb11c4035c6680af8c6d1", 0x398a59b4, 0x15, 1, 253,
+     "981ba6824c1bfb1ab485472029b71d808ce33e2cc3c0b5fc1f3de8a6dc66b1f0",
+     "5d5bfe75eb04f68ce0a12377ea00b37d47c6a0ba06309155086a859c4341b378"},
+    {"C.1 set 1", "128-NEA2", "d3c5d592327fb11c4035c6680af8c6d1", 0x398a59b4, 0x15, 1, 253,
+     "981ba6824c1bfb1ab485472029b71d808ce33e2cc3c0b5fc1f3de8a6dc66b1f0",
+     "e9fed8a63d155304d71df20bf3e82214b20ed7dad2f233dc3c22d7bdeeed8e78"},
+    {"C.3 set 1", "128-NEA3", "173d14ba5003731d7a60049470f00a29", 0x66035492, 0x0f, 0, 193,
+     "6cf65340735552ab0c9752fa6f9025fe0bd675d9005875b200",
+     "a6c85fc66afb8533aafc2518dfe784940ee1e4b030238cc800"},
+    {"C.4 set 1", "128-NIA1", "2bd6459f82c5b300952c49104881ff48", 0x38a6f056, 0x1f, 0, 88,
+     "3332346263393861373479", "731f1165"},
+    {"C.2 set 1", "128-NIA2", "d3c5d592327fb11c4035c6680af8c6d1", 0x398a59b4, 0x1a, 1, 64,
+     "484583d5afe082ae", "b93787e6"},
+    {"C.6 set 1", "128-NIA3", "00000000000000000000000000000000", 0x00000000, 0x00, 0, 1,
+     "00000000", "c8a9595e"},
+    {"C.6 set 2", "128-NIA3", "47054125561eb2dda94059da05097850", 0x561eb2dd, 0x14, 0, 90,
+     "000000000000000000000000", "6719a088"},
+};
+
+static const unsigned sizes[] = {3, 16, 64, 128, 256, 512, 1024, 1500, 4096, 9216};
+
+#define BENCH_MAX_SIZE 9216
+#define BENCH_KDF_JOBS 64
+
+static unsigned from_hex(const char *hex, uint8_t *out) {
+    unsigned n = 0;
+    while (hex[0] && hex[1]) {
+        unsigned v;
+        sscanf(hex, "%2x", &v);
+        out[n++] = (uint8_t) v;
+        hex += 2;
+    }
+    return n;
+}
+
+static const secu_algorithm_t *find_algorithm(const char *name) {
+    unsigned i;
+    for (i = 0; i < sizeof(algorithms) / sizeof(algorithms[0]); i++)
+        if (strcmp(algorithms[i].name, name) == 0) return &algorithms[i];
+    return NULL;
+}
+
+static int check_vector(const secu_vector_t *v) {
+    uint8_t                 key[16], message[64], expected[64], out[64] = {0};
+    const secu_algorithm_t *a = find_algorithm(v->algorithm);
+    nas_stream_cipher_t     cipher;
+    unsigned                len;
+
+    from_hex(v->key, key);
+    from_hex(v->message, message);
+    len = from_hex(v->expected, expected);
+
+    cipher.key        = key;
+    cipher.key_length = sizeof(key);
+    cipher.count      = v->count;
+    cipher.bearer     = v->bearer;
+    cipher.direction  = v->direction;
+    cipher.message    = message;
+    cipher.blength    = v->blength;
+    a->fn(&cipher, out);
+    return memcmp(out, expected, len) == 0;
+}
+
+/* RFC 4231 test case 2, through both the scalar and the batched path */
+static int check_kdf(void) {
+    static const char data[] = "what do ya want for nothing?";
+    uint8_t           expected[32], out[32], batch_out[2][32];
+    kdf_job_t         jobs[2];
+    unsigned          i;
+
+    from_hex("5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843", expected);
+    kdf((const uint8_t *) "Jefe", 4, (uint8_t *) data, sizeof(data) - 1, out, 32);
+    if (memcmp(out, expected, 32) != 0) return 0;
+
+    for (i = 0; i < 2; i++) {
+        jobs[i].key     = (const uint8_t *) "Jefe";
+        jobs[i].key_len = 4;
+        jobs[i].s       = (const uint8_t *) data;
+        jobs[i].s_len   = sizeof(data) - 1;
+        jobs[i].out     = batch_out[i];
+        jobs[i].out_len = 32;
+    }
+    kdf_batch(jobs, 2);
+    return memcmp(batch_out[0], expected, 32) == 0 && memcmp(batch_out[1], expected, 32) == 0;
+}
+
+/* Jobs of mixed key, S and output lengths against the scalar kdf(): ten take the
+ * multi-buffer path, more than one pass of lanes, the last three the scalar fallback
+ * with a key over one block, an S over KDF_BATCH_MAX_S_LEN or both */
+static int check_kdf_batch(void) {
+    static const unsigned key_len[] = {16, 32, 64, 1, 32, 20, 64, 33, 32, 16, 65, 32, 80};
+    static const unsigned s_len[]   = {7,   1, 55, 56, 64, 119, 120,
+                                       183, 0, 17, 7,  184, 200};
+    static const unsigned out_len[] = {32, 16, 32, 1, 31, 32, 8, 32, 32, 24, 32, 32, 16};
+    enum { jobs_n = sizeof(key_len) / sizeof(key_len[0]) };
+    uint8_t   key[2 * 64], s[2 * 256], expected[32], batch_out[jobs_n][32];
+    kdf_job_t jobs[jobs_n];
+    unsigned  i;
+    int       ok = 1;
+
+    for (i = 0; i < sizeof(key); i++) key[i] = (uint8_t)(i * 29u + 3u);
+    for (i = 0; i < sizeof(s); i++) s[i] = (uint8_t)(i * 17u + 11u);
+    for (i = 0; i < jobs_n; i++) {
+        jobs[i].key     = key + i;
+        jobs[i].key_len = key_len[i];
+        jobs[i].s       = s + i;
+        jobs[i].s_len   = s_len[i];
+        jobs[i].out     = batch_out[i];
+        jobs[i].out_len = out_len[i];
+    }
+    kdf_batch(jobs, jobs_n);
+
+    for (i = 0; i < jobs_n; i++) {
+        kdf(key + i, key_len[i], s + i, s_len[i], expected, out_len[i]);
+        ok &= memcmp(batch_out[i], expected, out_len[i]) == 0;
+    }
+    return ok;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(SECU_BENCH_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+typedef struct {
+    double   seconds;
+    uint64_t cycles;
+    uint64_t messages;
+} bench_result_t;
+
+static void report(const char *name, unsigned size, const bench_result_t *r) {
+    const double rate = (double) r->messages / r->seconds;
+    printf("%-14s %6u %12.0f %10.2f", name, size, rate, rate * size / 1e6);
+    if (r->cycles)
+        printf(" %10.2f\n", (double) r->cycles / ((double) r->messages * size));
+    else
+        printf(" %10s\n", "-");
+}
+
+static void bench_stream(const secu_algorithm_t *a, unsigned size, double min_seconds,
+                         uint8_t *message, uint8_t *out) {
+    static uint8_t      key[16] = {0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc5, 0xb3, 0x00,
+                              0x95, 0x2c, 0x49, 0x10, 0x48, 0x81, 0xff, 0x48};
+    nas_stream_cipher_t cipher;
+    bench_result_t      r     = {0, 0, 0};
+    uint64_t            iters = 1, i;
+
+    cipher.key        = key;
+    cipher.key_length = sizeof(key);
+    cipher.bearer     = 1;
+    cipher.direction  = SECU_DIRECTION_UPLINK;
+    cipher.message    = message;
+    cipher.blength    = size * 8;
+
+    while (r.seconds < min_seconds) {
+        const double   t0 = now_seconds();
+        const uint64_t c0 = now_cycles();
+        for (i = 0; i < iters; i++) {
+            cipher.count = (uint32_t) i;
+            a->fn(&cipher, out);
+        }
+        r.cycles += now_cycles() - c0;
+        r.seconds += now_seconds() - t0;
+        r.messages += iters;
+        iters *= 2;
+    }
+    report(a->name, size, &r);
+}
+
+static void bench_kdf(unsigned size, double min_seconds, uint8_t *s, uint8_t *out) {
+    static const uint8_t key[32] = {1};
+    kdf_job_t            jobs[BENCH_KDF_JOBS];
+    bench_result_t       scalar = {0, 0, 0}, batch = {0, 0, 0};
+    uint64_t             iters  = 1, i;
+    unsigned             j;
+
+    while (scalar.seconds < min_seconds) {
+        const double   t0 = now_seconds();
+        const uint64_t c0 = now_cycles();
+        for (i = 0; i < iters; i++) kdf(key, sizeof(key), s, size, out, 32);
+        scalar.cycles += now_cycles() - c0;
+        scalar.seconds += now_seconds() - t0;
+        scalar.messages += iters;
+        iters *= 2;
+    }
+    report("kdf", size, &scalar);
+
+    for (j = 0; j < BENCH_KDF_JOBS; j++) {
+        jobs[j].key     = key;
+        jobs[j].key_len = sizeof(key);
+        jobs[j].s       = s;
+        jobs[j].s_len   = size;
+        jobs[j].out     = out + 32 * j;
+        jobs[j].out_len = 32;
+    }
+    iters = 1;
+    while (batch.seconds < min_seconds) {
+        const double   t0 = now_seconds();
+        const uint64_t c0 = now_cycles();
+        for (i = 0; i < iters; i++) kdf_batch(jobs, BENCH_KDF_JOBS);
+        batch.cycles += now_cycles() - c0;
+        batch.seconds += now_seconds() - t0;
+        batch.messages += iters * BENCH_KDF_JOBS;
+        iters *= 2;
+    }
+    report("kdf_batch", size, &batch);
+}
+
+int main(int argc, char *argv[]) {
+    const double min_seconds = (argc > 1 ? atof(argv[1]) : 200.0) / 1000.0;
+    uint8_t *    message     = calloc(BENCH_MAX_SIZE, 1);
+    uint8_t *    out         = calloc(BENCH_MAX_SIZE > 32 * BENCH_KDF_JOBS ? BENCH_MAX_SIZE
+                                                                    : 32 * BENCH_KDF_JOBS,
+                              1);
+    unsigned     i, j;
+    int          failed = 0;
+
+    for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        const int ok = check_vector(&vectors[i]);
+        printf("%-10s %-10s %s\n", vectors[i].algorithm, vectors[i].set, ok ? "ok" : "FAIL");
+        failed |= !ok;
+    }
+    {
+        const int ok = check_kdf();
+        printf("%-10s %-10s %s\n", "KDF", "RFC 4231-2", ok ? "ok" : "FAIL");
+        failed |= !ok;
+    }
+    {
+        const int ok = check_kdf_batch();
+        printf("%-10s %-10s %s\n", "KDF batch", "mixed", ok ? "ok" : "FAIL");
+        failed |= !ok;
+    }
+    if (failed) {
+        free(message);
+        free(out);
+        return 1;
+    }
+
+    for (i = 0; i < BENCH_MAX_SIZE; i++) message[i] = (uint8_t)(i * 131u + 7u);
+
+#if !defined(__OPTIMIZE__)
+    printf("\nwarning: built without optimisation, configure with "
+           "-DCMAKE_BUILD_TYPE=Release for representative numbers\n");
+#endif
+
+    printf("\n%-14s %6s %12s %10s %10s\n", "algorithm", "bytes", "msg/s", "MB/s", "cycles/B");
+    for (i = 0; i < sizeof(algorithms) / sizeof(algorithms[0]); i++)
+        for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+            bench_stream(&algorithms[i], sizes[j], min_seconds, message, out);
+    for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++)
+        bench_kdf(sizes[j], min_seconds, message, out);
+
+    free(message);
+    free(out);
+    return 0;
+}
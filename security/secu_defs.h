@@ -27,6 +27,11 @@
 #define SECU_DIRECTION_UPLINK 0
 #define SECU_DIRECTION_DOWNLINK 1
 
+static inline uint32_t hton_int32(uint32_t x) {
+    return ((x & 0x000000FFu) << 24u) | ((x & 0x0000FF00u) << 8u) |
+           ((x & 0x00FF0000u) >> 8u) | ((x & 0xFF000000u) >> 24u);
+}
+
 void kdf(const uint8_t *key,
          const unsigned key_len,
          uint8_t *      s,
@@ -34,6 +39,30 @@ void kdf(const uint8_t *key,
          uint8_t *      out,
          const unsigned out_len);
 
+/* One independent HMAC-SHA256 derivation for kdf_batch */
+typedef struct {
+    const uint8_t *key;
+    unsigned       key_len;
+    const uint8_t *s;
+    unsigned       s_len;
+    uint8_t *      out;
+    unsigned       out_len;
+} kdf_job_t;
+
+/* S longer than this (or keys over one block) goes through the scalar kdf() */
+#define KDF_BATCH_MAX_S_LEN 183
+#define KDF_BATCH_MAX_BLOCKS 4
+
+/*!
+   @brief Run many independent kdf() derivations at once, interleaving up to eight
+   HMAC-SHA256 chains through the multi-buffer SHA-256 kernel. Meant for bulk
+   re-keying such as registration storms; a single job takes the scalar path, and so
+   does every job on a SHA-NI host, where nettle hashes one chain as fast.
+   @param[in,out] jobs derivation inputs, results are written to jobs[i].out
+   @param[in] n number of jobs
+*/
+void kdf_batch(kdf_job_t *jobs, const unsigned n);
+
 int derive_keNB(const uint8_t *kasme_32, const uint32_t nas_count, uint8_t *keNB);
 
 int derive_key_nas(algorithm_type_dist_t nas_alg_type,
@@ -72,6 +101,15 @@ int nas_stream_encrypt_nea1(nas_stream_cipher_t *const stream_cipher, uint8_t *c
 
 int nas_stream_encrypt_nea2(nas_stream_cipher_t *const stream_cipher, uint8_t *const out);
 
+int nas_stream_encrypt_nea3(nas_stream_cipher_t *const stream_cipher, uint8_t *const out);
+
+/* 128-NIA1/2/3 (TS 33.501 D.3), the 32 bits MAC goes to out[0..3] */
+int nas_stream_encrypt_nia1(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]);
+
+int nas_stream_encrypt_nia2(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]);
+
+int nas_stream_encrypt_nia3(nas_stream_cipher_t *const stream_cipher, uint8_t out[4]);
+
 
 
 #endif /* FILE_SECU_DEFS_SEEN */
@@ -0,0 +1,357 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "sha256_mb.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SHA256_MB_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2};
+
+static const uint32_t H256[8] = {0x6a09e667,
+                                 0xbb67ae85,
+                                 0x3c6ef372,
+                                 0xa54ff53a,
+                                 0x510e527f,
+                                 0x9b05688c,
+                                 0x1f83d9ab,
+                                 0x5be0cd19};
+
+void sha256_state_init(sha256_state_t *state) { memcpy(state->h, H256, sizeof(H256)); }
+
+void sha256_state_digest(const sha256_state_t *state, uint8_t *out, unsigned out_len) {
+    uint8_t  tmp[SHA256_DIGEST_SIZE];
+    unsigned i;
+
+    for (i = 0; i < 8; i++) {
+        tmp[4 * i + 0] = (uint8_t)(state->h[i] >> 24u);
+        tmp[4 * i + 1] = (uint8_t)(state->h[i] >> 16u);
+        tmp[4 * i + 2] = (uint8_t)(state->h[i] >> 8u);
+        tmp[4 * i + 3] = (uint8_t)(state->h[i]);
+    }
+    if (out_len > SHA256_DIGEST_SIZE) out_len = SHA256_DIGEST_SIZE;
+    memcpy(out, tmp, out_len);
+}
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32u - (n))))
+
+static uint32_t load_be32(const uint8_t *p) {
+    return (uint32_t) p[0] << 24u | (uint32_t) p[1] << 16u | (uint32_t) p[2] << 8u |
+           (uint32_t) p[3];
+}
+
+/* FIPS 180-4 6.2.2, one lane at a time */
+static void sha256_compress_c(uint32_t h[8], const uint8_t *data, unsigned nblocks) {
+    uint32_t w[64];
+    uint32_t a, b, c, d, e, f, g, k, t1, t2;
+    unsigned t;
+
+    for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_SIZE) {
+        for (t = 0; t < 16; t++) w[t] = load_be32(data + 4 * t);
+        for (t = 16; t < 64; t++) {
+            const uint32_t s0 = ROR32(w[t - 15], 7u) ^ ROR32(w[t - 15], 18u) ^ (w[t - 15] >> 3u);
+            const uint32_t s1 = ROR32(w[t - 2], 17u) ^ ROR32(w[t - 2], 19u) ^ (w[t - 2] >> 10u);
+            w[t]              = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        a = h[0], b = h[1], c = h[2], d = h[3];
+        e = h[4], f = h[5], g = h[6], k = h[7];
+        for (t = 0; t < 64; t++) {
+            t1 = k + (ROR32(e, 6u) ^ ROR32(e, 11u) ^ ROR32(e, 25u)) + ((e & f) ^ (~e & g)) +
+                 K256[t] + w[t];
+            t2 = (ROR32(a, 2u) ^ ROR32(a, 13u) ^ ROR32(a, 22u)) + ((a & b) ^ (a & c) ^ (b & c));
+            k  = g;
+            g  = f;
+            f  = e;
+            e  = d + t1;
+            d  = c;
+            c  = b;
+            b  = a;
+            a  = t1 + t2;
+        }
+        h[0] += a, h[1] += b, h[2] += c, h[3] += d;
+        h[4] += e, h[5] += f, h[6] += g, h[7] += k;
+    }
+}
+
+#if defined(SHA256_MB_X86)
+
+#define SHANI_LOAD_STATE(h, s0, s1)                      \
+    do {                                                 \
+        __m128i t_ = _mm_loadu_si128((const __m128i *) &(h)[0]); \
+        s1         = _mm_loadu_si128((const __m128i *) &(h)[4]); \
+        t_         = _mm_shuffle_epi32(t_, 0xb1);    /* CDAB */ \
+        s1         = _mm_shuffle_epi32(s1, 0x1b);    /* EFGH */ \
+        s0         = _mm_alignr_epi8(t_, s1, 8);     /* ABEF */ \
+        s1         = _mm_blend_epi16(s1, t_, 0xf0);  /* CDGH */ \
+    } while (0)
+
+#define SHANI_STORE_STATE(h, s0, s1)                     \
+    do {                                                 \
+        __m128i t_ = _mm_shuffle_epi32(s0, 0x1b);    /* FEBA */ \
+        s1         = _mm_shuffle_epi32(s1, 0xb1);    /* DCHG */ \
+        s0         = _mm_blend_epi16(t_, s1, 0xf0);  /* DCBA */ \
+        s1         = _mm_alignr_epi8(s1, t_, 8);     /* ABEF */ \
+        _mm_storeu_si128((__m128i *) &(h)[0], s0);   \
+        _mm_storeu_si128((__m128i *) &(h)[4], s1);   \
+    } while (0)
+
+/* message group g of 16; groups past the fourth extend the schedule in place */
+#define SHANI_SCHEDULE(m, data, g, bswap)                                                 \
+    do {                                                                                  \
+        if ((g) < 4) {                                                                    \
+            m[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) ((data) + 16 * (g))), \
+                                    bswap);                                               \
+        } else {                                                                          \
+            __m128i t_ = _mm_sha256msg1_epu32(m[(g) &3u], m[((g) + 1) & 3u]);             \
+            t_ = _mm_add_epi32(t_, _mm_alignr_epi8(m[((g) + 3) & 3u], m[((g) + 2) & 3u], 4)); \
+            m[(g) &3u] = _mm_sha256msg2_epu32(t_, m[((g) + 3) & 3u]);                     \
+        }                                                                                 \
+    } while (0)
+
+#define SHANI_ROUNDS(m, g, s0, s1)                                                        \
+    do {                                                                                  \
+        __m128i k_ = _mm_add_epi32(m[(g) &3u], _mm_loadu_si128((const __m128i *) &K256[4 * (g)])); \
+        s1         = _mm_sha256rnds2_epu32(s1, s0, k_);                                   \
+        k_         = _mm_shuffle_epi32(k_, 0x0e);                                         \
+        s0         = _mm_sha256rnds2_epu32(s0, s1, k_);                                   \
+    } while (0)
+
+/* Intel SHA extensions, one lane */
+__attribute__((target("sha,sse4.1"))) static void sha256_compress_shani(
+    uint32_t h[8], const uint8_t *data, unsigned nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i       state0, state1, abef, cdgh;
+    __m128i       m[4];
+    unsigned      g;
+
+    SHANI_LOAD_STATE(h, state0, state1);
+    for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_SIZE) {
+        abef = state0;
+        cdgh = state1;
+        for (g = 0; g < 16; g++) {
+            SHANI_SCHEDULE(m, data, g, bswap);
+            SHANI_ROUNDS(m, g, state0, state1);
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+    SHANI_STORE_STATE(h, state0, state1);
+}
+
+/* Two lanes interleaved so the rounds unit always has an independent stream to
+ * work on while the other waits on sha256rnds2 latency */
+__attribute__((target("sha,sse4.1"))) static void sha256_compress_shani_x2(
+    uint32_t ha[8], const uint8_t *a, uint32_t hb[8], const uint8_t *b, unsigned nblocks) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i       a0, a1, b0, b1, a_abef, a_cdgh, b_abef, b_cdgh;
+    __m128i       ma[4], mb[4];
+    unsigned      g;
+
+    SHANI_LOAD_STATE(ha, a0, a1);
+    SHANI_LOAD_STATE(hb, b0, b1);
+    for (; nblocks > 0; nblocks--, a += SHA256_BLOCK_SIZE, b += SHA256_BLOCK_SIZE) {
+        a_abef = a0, a_cdgh = a1;
+        b_abef = b0, b_cdgh = b1;
+        for (g = 0; g < 16; g++) {
+            SHANI_SCHEDULE(ma, a, g, bswap);
+            SHANI_SCHEDULE(mb, b, g, bswap);
+            SHANI_ROUNDS(ma, g, a0, a1);
+            SHANI_ROUNDS(mb, g, b0, b1);
+        }
+        a0 = _mm_add_epi32(a0, a_abef), a1 = _mm_add_epi32(a1, a_cdgh);
+        b0 = _mm_add_epi32(b0, b_abef), b1 = _mm_add_epi32(b1, b_cdgh);
+    }
+    SHANI_STORE_STATE(ha, a0, a1);
+    SHANI_STORE_STATE(hb, b0, b1);
+}
+
+__attribute__((target("sha,sse4.1"))) static void sha256_mb_compress_shani(
+    sha256_state_t *      states,
+    const uint8_t *const *blocks,
+    const unsigned *      nblocks,
+    unsigned              lanes) {
+    unsigned i;
+
+    for (i = 0; i + 1 < lanes; i += 2) {
+        const unsigned common = nblocks[i] < nblocks[i + 1] ? nblocks[i] : nblocks[i + 1];
+        sha256_compress_shani_x2(
+            states[i].h, blocks[i], states[i + 1].h, blocks[i + 1], common);
+        sha256_compress_shani(
+            states[i].h, blocks[i] + common * SHA256_BLOCK_SIZE, nblocks[i] - common);
+        sha256_compress_shani(states[i + 1].h,
+                              blocks[i + 1] + common * SHA256_BLOCK_SIZE,
+                              nblocks[i + 1] - common);
+    }
+    if (i < lanes) sha256_compress_shani(states[i].h, blocks[i], nblocks[i]);
+}
+
+#define MB_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+/* 8 lanes, one 32-bit word of each lane per vector element */
+__attribute__((target("avx2"))) static void sha256_mb_compress_avx2(
+    sha256_state_t *      states,
+    const uint8_t *const *blocks,
+    const unsigned *      nblocks,
+    unsigned              lanes) {
+    const __m256i bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                          12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+    static const uint8_t zero[SHA256_BLOCK_SIZE] = {0};
+    const uint8_t *      p[SHA256_MB_LANES];
+    uint32_t             lane_blocks[SHA256_MB_LANES];
+    uint32_t             tmp[SHA256_MB_LANES];
+    __m256i              s[8], w[16], v[8];
+    __m256i              t1, t2, active;
+    unsigned             i, j, t, b, max_blocks = 0;
+
+    for (i = 0; i < SHA256_MB_LANES; i++) {
+        lane_blocks[i] = i < lanes ? nblocks[i] : 0;
+        if (lane_blocks[i] > max_blocks) max_blocks = lane_blocks[i];
+    }
+    /* transpose the chaining values into word-sliced form */
+    for (j = 0; j < 8; j++) {
+        for (i = 0; i < SHA256_MB_LANES; i++) tmp[i] = i < lanes ? states[i].h[j] : 0;
+        s[j] = _mm256_loadu_si256((const __m256i *) tmp);
+    }
+
+    for (b = 0; b < max_blocks; b++) {
+        for (i = 0; i < SHA256_MB_LANES; i++) {
+            p[i]   = b < lane_blocks[i] ? blocks[i] + b * SHA256_BLOCK_SIZE : zero;
+            tmp[i] = b < lane_blocks[i] ? 0xffffffffu : 0;
+        }
+        active = _mm256_loadu_si256((const __m256i *) tmp);
+
+        for (t = 0; t < 16; t++) {
+            uint32_t x[SHA256_MB_LANES];
+            for (i = 0; i < SHA256_MB_LANES; i++) memcpy(&x[i], p[i] + 4 * t, 4);
+            w[t] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *) x), bswap);
+        }
+
+        for (j = 0; j < 8; j++) v[j] = s[j];
+
+        for (t = 0; t < 64; t++) {
+            __m256i wt;
+            if (t < 16) {
+                wt = w[t];
+            } else {
+                const __m256i w15 = w[(t - 15) & 15u];
+                const __m256i w2  = w[(t - 2) & 15u];
+                const __m256i s0  = _mm256_xor_si256(
+                    _mm256_xor_si256(MB_ROR(w15, 7), MB_ROR(w15, 18)), _mm256_srli_epi32(w15, 3));
+                const __m256i s1 = _mm256_xor_si256(
+                    _mm256_xor_si256(MB_ROR(w2, 17), MB_ROR(w2, 19)), _mm256_srli_epi32(w2, 10));
+                wt = _mm256_add_epi32(_mm256_add_epi32(w[t & 15u], s0),
+                                      _mm256_add_epi32(w[(t - 7) & 15u], s1));
+                w[t & 15u] = wt;
+            }
+
+            /* t1 = h + S1(e) + ch(e,f,g) + K[t] + W[t] */
+            t1 = _mm256_xor_si256(_mm256_xor_si256(MB_ROR(v[4], 6), MB_ROR(v[4], 11)),
+                                  MB_ROR(v[4], 25));
+            t1 = _mm256_add_epi32(t1, v[7]);
+            t1 = _mm256_add_epi32(
+                t1,
+                _mm256_xor_si256(_mm256_and_si256(v[4], v[5]), _mm256_andnot_si256(v[4], v[6])));
+            t1 = _mm256_add_epi32(t1, _mm256_add_epi32(_mm256_set1_epi32((int) K256[t]), wt));
+
+            /* t2 = S0(a) + maj(a,b,c) */
+            t2 = _mm256_xor_si256(_mm256_xor_si256(MB_ROR(v[0], 2), MB_ROR(v[0], 13)),
+                                  MB_ROR(v[0], 22));
+            t2 = _mm256_add_epi32(
+                t2,
+                _mm256_xor_si256(
+                    _mm256_xor_si256(_mm256_and_si256(v[0], v[1]), _mm256_and_si256(v[0], v[2])),
+                    _mm256_and_si256(v[1], v[2])));
+
+            v[7] = v[6];
+            v[6] = v[5];
+            v[5] = v[4];
+            v[4] = _mm256_add_epi32(v[3], t1);
+            v[3] = v[2];
+            v[2] = v[1];
+            v[1] = v[0];
+            v[0] = _mm256_add_epi32(t1, t2);
+        }
+
+        /* lanes that ran out of blocks keep their chaining value */
+        for (j = 0; j < 8; j++) s[j] = _mm256_blendv_epi8(s[j], _mm256_add_epi32(s[j], v[j]), active);
+    }
+
+    for (j = 0; j < 8; j++) {
+        _mm256_storeu_si256((__m256i *) tmp, s[j]);
+        for (i = 0; i < lanes; i++) states[i].h[j] = tmp[i];
+    }
+}
+
+enum { SHA256_KERNEL_UNKNOWN = 0, SHA256_KERNEL_C, SHA256_KERNEL_AVX2, SHA256_KERNEL_SHANI };
+
+static int sha256_kernel_detect(void) {
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    int      sse41 = 0, sha = 0;
+
+    __builtin_cpu_init();
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) sse41 = (ecx >> 19u) & 1u;
+    if (__get_cpuid_max(0, 0) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        sha = (ebx >> 29u) & 1u;
+    }
+    if (sha && sse41) return SHA256_KERNEL_SHANI;
+    if (__builtin_cpu_supports("avx2")) return SHA256_KERNEL_AVX2;
+    return SHA256_KERNEL_C;
+}
+
+static int sha256_kernel(void) {
+    static volatile int kernel = SHA256_KERNEL_UNKNOWN;
+    if (kernel == SHA256_KERNEL_UNKNOWN) kernel = sha256_kernel_detect();
+    return kernel;
+}
+
+#endif /* SHA256_MB_X86 */
+
+int sha256_mb_wide(void) {
+#if defined(SHA256_MB_X86)
+    return sha256_kernel() == SHA256_KERNEL_AVX2;
+#else
+    return 0;
+#endif
+}
+
+void sha256_mb_compress(sha256_state_t *      states,
+                        const uint8_t *const *blocks,
+                        const unsigned *      nblocks,
+                        unsigned              lanes) {
+    unsigned i;
+
+    if (lanes > SHA256_MB_LANES) lanes = SHA256_MB_LANES;
+
+#if defined(SHA256_MB_X86)
+    switch (sha256_kernel()) {
+    case SHA256_KERNEL_SHANI:
+        sha256_mb_compress_shani(states, blocks, nblocks, lanes);
+        return;
+    case SHA256_KERNEL_AVX2:
+        if (lanes > 1) {
+            sha256_mb_compress_avx2(states, blocks, nblocks, lanes);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+#endif
+
+    for (i = 0; i < lanes; i++) sha256_compress_c(states[i].h, blocks[i], nblocks[i]);
+}
@@ -0,0 +1,41 @@
+#ifndef FILE_SHA256_MB_SEEN
+#define FILE_SHA256_MB_SEEN
+
+#include <stdint.h>
+
+/* number of independent messages one multi-buffer pass works on */
+#define SHA256_MB_LANES 8
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_DIGEST_SIZE 32
+
+typedef struct {
+    uint32_t h[8];
+} sha256_state_t;
+
+/* Load the FIPS 180-4 initial hash value into state. */
+void sha256_state_init(sha256_state_t *state);
+
+/*!
+   @brief Compress up to SHA256_MB_LANES independent block streams in one pass.
+   Lane i runs nblocks[i] 64-byte blocks from blocks[i] through states[i]; lanes
+   may have different block counts. The kernel is picked once at runtime: SHA-NI
+   when the CPU has it, 8-lane AVX2 otherwise, portable C as the last resort.
+   @param[in,out] states chaining values, one per lane
+   @param[in] blocks padded message blocks, one pointer per lane
+   @param[in] nblocks number of blocks per lane
+   @param[in] lanes number of lanes in use, at most SHA256_MB_LANES
+*/
+void sha256_mb_compress(sha256_state_t *      states,
+                        const uint8_t *const *blocks,
+                        const unsigned *      nblocks,
+                        unsigned              lanes);
+
+/* Nonzero when one pass over several lanes beats hashing them one after the other,
+   that is with the 8-lane AVX2 kernel. SHA-NI runs one stream about as fast as two
+   interleaved ones and nettle already uses it, callers with a scalar path take that. */
+int sha256_mb_wide(void);
+
+/* Write the big-endian digest of state to out (out_len <= 32). */
+void sha256_state_digest(const sha256_state_t *state, uint8_t *out, unsigned out_len);
+
+#endif /* FILE_SHA256_MB_SEEN */
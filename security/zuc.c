@@ -269,7 +269,13 @@ void EEA3(uint8_t* CK, uint32_t COUNT, uint32_t BEARER, uint32_t DIRECTION, uint
         C[i] = M[i] ^ z[i];
     }
     free(z);
-    if (lastbits) C[LENGTH / 32] &= 1024 - (1 << lastbits);
+    if (lastbits) {
+        /* C holds the stream in octet order, clear the bits past LENGTH */
+        uint8_t *c     = (uint8_t *) C;
+        uint32_t bytes = (LENGTH + 7) / 8;
+        if (LENGTH % 8) c[bytes - 1] &= (uint8_t)(0xFF << (8 - LENGTH % 8));
+        memset(c + bytes, 0, L * 4 - bytes);
+    }
 }
 
 void ZUC_EEA3(unsigned char* key,
@@ -278,7 +284,8 @@ void ZUC_EEA3(unsigned char* key,
               unsigned int   DIRECTION,
               unsigned char* data,
               unsigned int   length) {
-    uint32_t* M    = (uint32_t*) malloc(length + 1);
+    /* EEA3 works on whole 32 bits words */
+    uint32_t* M    = (uint32_t*) calloc((length + 3) / 4, 4);
     int  num  = length / 4;
     int  cnum = length % 4;
     int  n    = 0;
@@ -289,7 +296,7 @@ void ZUC_EEA3(unsigned char* key,
         memcpy(&M[n], data + n * 4, cnum);
     }
 
-    uint32_t* C = (unsigned int*) malloc(length + 1);
+    uint32_t* C = (unsigned int*) calloc((length + 3) / 4, 4);
 
     EEA3(key, COUNT, BEARER, DIRECTION, length * 8, M, C);
 
@@ -14,6 +14,9 @@
     @P C    加密输出数据
 */
 
+/* ZUC keystream generator: len 32 bits words from 128 bits key k and iv */
+void ZUC(uint8_t* k, uint8_t* iv, uint32_t* ks, int len);
+
 void EEA3(uint8_t* CK, uint32_t COUNT, uint32_t BEARER, uint32_t DIRECTION, uint32_t LENGTH, uint32_t* M, uint32_t* C);
 
 void ZUC_EEA3(unsigned char* key,